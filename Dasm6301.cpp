@@ -39,14 +39,14 @@ return pDasm;
 }
 
 /*****************************************************************************/
-/* Auto-registration                                                         */
+/* RegisterDasm6301 : register the 6301 disassemblers                        */
 /*****************************************************************************/
 
-static bool bRegistered[] =
-  {
-  RegisterDisassembler("6301", Create6301),
-  RegisterDisassembler("6303", Create6301),
-  };
+bool RegisterDasm6301()
+{
+return RegisterDisassembler("6301", Create6301) &&
+       RegisterDisassembler("6303", Create6301);
+}
 
 
 /*===========================================================================*/
@@ -57,7 +57,7 @@ static bool bRegistered[] =
 /* m6301_codes : table of all 6301 instruction bytes and types               */
 /*****************************************************************************/
 
-uint8_t Dasm6301::h6301_codes[512] =
+Dasm6800::OpDef Dasm6301::h6301_codes[256] =
   {
   _ill  ,_nom,   _nop  ,_imp,   _ill  ,_nom,   _ill  ,_nom,     /* 00..03 */
   _lsrd ,_imp,   _asld ,_imp,   _tap  ,_imp,   _tpa  ,_imp,     /* 04..07 */
@@ -139,16 +139,35 @@ OpCode Dasm6301::opcodes[mnemo6301_count - mnemo6801_count] =
     { "XGDX",  Data },                  /* _xgdx                             */
   };
 
+/*****************************************************************************/
+/* h6301_descs : 6301 mnemonics and instruction descriptors                  */
+/*****************************************************************************/
+
+OpCode Dasm6301::h6301_mnemo[mnemo6301_count];
+Dasm6800::OpDesc Dasm6301::h6301_descs[256];
+bool Dasm6301::bDescsBuilt = Dasm6301::SetupMnemonics(h6301_mnemo) &&
+                             BuildDescs(h6301_descs, h6301_mnemo, h6301_codes);
+
+/*****************************************************************************/
+/* SetupMnemonics : fill a variant's mnemonics table with the 6301 part      */
+/*****************************************************************************/
+
+bool Dasm6301::SetupMnemonics(OpCode *mnemos)
+{
+Dasm6801::SetupMnemonics(mnemos);
+for (int i = 0; i < mnemo6301_count - mnemo6801_count; i++)
+  mnemos[mnemo6801_count + i] = opcodes[i];
+return true;
+}
+
 /*****************************************************************************/
 /* Dasm6301 : constructor                                                    */
 /*****************************************************************************/
 
 Dasm6301::Dasm6301(void)
 {
-codes = h6301_codes;
-mnemo.resize(mnemo6301_count);          /* set up additional mnemonics       */
-for (int i = 0; i < mnemo6301_count - mnemo6801_count; i++)
-  mnemo[mnemo6801_count + i] = opcodes[i];
+descs = h6301_descs;
+mnemoTbl = h6301_mnemo;
 }
 
 /*****************************************************************************/
@@ -206,7 +225,7 @@ switch (M)                              /* which mode is this ?              */
     if (bSetLabel)
       {
       W = (uint16_t)PhaseInner(W, PC);
-      AddLabel(W, mnemo[MI].memType, "", true);
+      AddLabel(W, mnemoTbl[MI].memType, "", true);
       }
     PC++;
     break;
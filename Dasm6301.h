@@ -67,8 +67,12 @@ class Dasm6301 : public Dasm6801
       };
 
 
-    static uint8_t h6301_codes[512];
+    static OpDef h6301_codes[256];
     static OpCode opcodes[mnemo6301_count - mnemo6801_count];
+    static OpCode h6301_mnemo[mnemo6301_count];
+    static OpDesc h6301_descs[256];
+    static bool bDescsBuilt;
+    static bool SetupMnemonics(OpCode *mnemos);
   };
 
 #endif // __Dasm6301_h_defined__
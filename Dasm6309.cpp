@@ -39,10 +39,13 @@ return pDasm;
 }
 
 /*****************************************************************************/
-/* Auto-registration                                                         */
+/* RegisterDasm6309 : register the 6309 disassembler                         */
 /*****************************************************************************/
 
-static bool bRegistered = RegisterDisassembler("6309", Create6309);
+bool RegisterDasm6309()
+{
+return RegisterDisassembler("6309", Create6309);
+}
 
 
 /*===========================================================================*/
@@ -53,7 +56,7 @@ static bool bRegistered = RegisterDisassembler("6309", Create6309);
 /* m6309_codes : table of all 6309 instruction bytes and types               */
 /*****************************************************************************/
 
-uint8_t Dasm6309::h6309_codes[512] =
+Dasm6800::OpDef Dasm6309::h6309_codes[256] =
   {
   _neg  ,_dir,   _oim  ,_bd ,   _aim  ,_bd ,   _com  ,_dir,     /* 00..03 */
   _lsr  ,_dir,   _eim  ,_bd ,   _ror  ,_dir,   _asr  ,_dir,     /* 04..07 */
@@ -125,7 +128,7 @@ uint8_t Dasm6309::h6309_codes[512] =
 /*hm6309_codes10 : $10 extended instruction 2nd byte                         */
 /*****************************************************************************/
 
-uint8_t Dasm6309::h6309_codes10[512] =
+Dasm6800::OpDef Dasm6309::h6309_codes10[256] =
   {
   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,     /* 00..03 */
   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,     /* 04..07 */
@@ -197,7 +200,7 @@ uint8_t Dasm6309::h6309_codes10[512] =
 /* h6309_codes11 : $11 extended instruction 2nd byte                         */
 /*****************************************************************************/
 
-uint8_t Dasm6309::h6309_codes11[512] =
+Dasm6800::OpDef Dasm6309::h6309_codes11[256] =
   {
   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,     /* 00..03 */
   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,     /* 04..07 */
@@ -360,20 +363,45 @@ OpCode Dasm6309::opcodes[mnemo6309_count - mnemo6809_count] =
     { "TSTW",  Data },                  /* _tstw                             */
   };
 
+/*****************************************************************************/
+/* h6309_descs : 6309 mnemonics and instruction descriptors                  */
+/*****************************************************************************/
+
+OpCode Dasm6309::h6309_mnemo[mnemo6309_count];
+Dasm6800::OpDesc Dasm6309::h6309_descs[3 * 256];
+bool Dasm6309::bDescsBuilt = Dasm6309::SetupMnemonics(h6309_mnemo) &&
+                             BuildDescs(h6309_descs, h6309_mnemo,
+                                        h6309_codes, h6309_codes10, h6309_codes11);
+
+/*****************************************************************************/
+/* SetupMnemonics : fill a variant's mnemonics table with the 6309 part      */
+/*****************************************************************************/
+
+bool Dasm6309::SetupMnemonics(OpCode *mnemos)
+{
+Dasm6809::SetupMnemonics(mnemos);
+for (int i = 0; i < mnemo6309_count - mnemo6809_count; i++)
+  mnemos[mnemo6809_count + i] = opcodes[i];
+return true;
+}
+
+/*****************************************************************************/
+/* h6309_index : indexed addressing post byte descriptions                   */
+/*****************************************************************************/
+
+Dasm6809::IndexDef Dasm6309::h6309_index[256];
+bool Dasm6309::bIndexDefsBuilt = Dasm6309::BuildIndexDefs(h6309_index);
+
 /*****************************************************************************/
 /* Dasm6309 : constructor                                                    */
 /*****************************************************************************/
 
 Dasm6309::Dasm6309(void)
 {
-codes = h6309_codes;
-codes10 = h6309_codes10;
-codes11 = h6309_codes11;
+descs = h6309_descs;
+mnemoTbl = h6309_mnemo;
 exg_tfr = h6309_exg_tfr;
-
-mnemo.resize(mnemo6309_count);          /* set up additional mnemonics       */
-for (int i = 0; i < mnemo6309_count - mnemo6809_count; i++)
-  mnemo[mnemo6809_count + i] = opcodes[i];
+indexDefs = h6309_index;
 }
 
 /*****************************************************************************/
@@ -421,143 +449,40 @@ return Dasm6809::InitParse(bus);
 }
 
 /*****************************************************************************/
-/* IndexParse : parses index for labels                                      */
+/* BuildIndexDefs : set up the indexed addressing post byte descriptions     */
 /*****************************************************************************/
 
-addr_t Dasm6309::IndexParse(int MI, addr_t pc)
+bool Dasm6309::BuildIndexDefs(IndexDef *defs)
 {
-uint8_t T;
-uint16_t W;
-char R;
-addr_t PC = pc;
-bool bSetLabel = true;
-Label *lbl;
-
-T = GetUByte(PC++);
-R = reg[(T >> 5) & 0x03];
-
-if (T & 0x80)
-  {
-  switch(T & 0x1F)
-    {
-    case 0x07:
-    case 0x17:
-    case 0x0A:
-    case 0x1A:
-    case 0x0E:
-    case 0x1E:
-      return PC;
-    default:
-      switch (T)
-        {
-        case 0xAF:
-        case 0xB0:
-          bSetLabel = !IsConst(PC);
-          lbl = bSetLabel ? NULL : FindLabel(PC, Const);
-          if (lbl)
-            lbl->SetUsed();
-          SetCellSize(PC, 2);
-          W = GetUWord(PC); PC += 2;
-          if (bSetLabel)
-            AddLabel(W, mnemo[MI].memType, "", true);
-          return PC;
-        }
-      break;
-    }
-  }
-return Dasm6809::IndexParse(MI, pc);
-}
-
-/*****************************************************************************/
-/* IndexString : converts index to string                                    */
-/*****************************************************************************/
-
-string Dasm6309::IndexString(addr_t &pc)
-{
-uint8_t T;
-uint16_t W;
-char R;
-string buf;
-addr_t PC = pc;
-bool bGetLabel;
-Label *lbl;
-
-T = GetUByte(PC++);
-R = reg[(T >> 5) & 0x03];
-
-if (T & 0x80)
+Dasm6809::BuildIndexDefs(defs);         /* start with the 6809 definitions   */
+for (int T = 0x80; T < 256; T++)
   {
+  IndexDef &idx = defs[T];
+  char R = reg[(T >> 5) & 0x03];
   switch (T & 0x1F)
     {
-    case 0x07:
-      buf = sformat("E,%c", R);
-      break;
-    case 0x17:
-      buf = sformat("[E,%c]", R);
-      break;
-    case 0x0A:
-      buf = sformat("F,%c",R);
-      break;
-    case 0x1A:
-      buf = sformat("[F,%c]",R);
-      break;
-    case 0x0E:
-      buf = sformat("W,%c",R);
-      break;
-    case 0x1E:
-      buf = sformat("[W,%c]",R);
-      break;
-    default:
-      switch (T)
-        {
-        case 0x8F:
-          buf = sformat(",W");
-          break;
-        case 0x90:
-          buf = sformat("[,W]");
-          break;
-        case 0xAF:
-          {
-          bGetLabel = !IsConst(PC);
-          lbl = bGetLabel ? NULL : FindLabel(PC, Const);
-          W = GetUWord(PC);
-          string slbl = lbl ? lbl->GetText() : Label2String(W, 4, bGetLabel, PC);
-          buf = sformat("%s,W", slbl.c_str());
-          PC += 2;
-          }
-          break;
-        case 0xB0:
-          {
-          bGetLabel = !IsConst(PC);
-          lbl = bGetLabel ? NULL : FindLabel(PC, Const);
-          W = GetUWord(PC);
-          string slbl = lbl ? lbl->GetText() : Label2String(W, 4, bGetLabel, PC);
-          buf = sformat("[%s,W]", slbl.c_str());
-          PC += 2;
-          }
-          break;
-        case 0xCF:
-          buf = sformat(",W++");
-          break;
-        case 0xD0:
-          buf = sformat("[,W++]");
-          break;
-        case 0xEF:
-          buf = sformat(",--W");
-          break;
-        case 0xF0:
-          buf = sformat("[,--W]");
-          break;
-        default:
-          return Dasm6809::IndexString(pc);
-        }
-      break;
+    case 0x07: sprintf(idx.text, "E,%c", R);     break;
+    case 0x17: sprintf(idx.text, "[E,%c]", R);   break;
+    case 0x0A: sprintf(idx.text, "F,%c", R);     break;
+    case 0x1A: sprintf(idx.text, "[F,%c]", R);   break;
+    case 0x0E: sprintf(idx.text, "W,%c", R);     break;
+    case 0x1E: sprintf(idx.text, "[W,%c]", R);   break;
     }
-  pc = PC;
-  return buf;
   }
-
-return Dasm6809::IndexString(pc);
+                                        /* W register based modes            */
+strcpy(defs[0x8F].text, ",W");
+strcpy(defs[0x90].text, "[,W]");
+strcpy(defs[0xCF].text, ",W++");
+strcpy(defs[0xD0].text, "[,W++]");
+strcpy(defs[0xEF].text, ",--W");
+strcpy(defs[0xF0].text, "[,--W]");
+defs[0xAF].mode = idxAbs16;
+defs[0xAF].indirect = 0;
+strcpy(defs[0xAF].text, ",W");
+defs[0xB0].mode = idxAbs16;
+defs[0xB0].indirect = 1;
+strcpy(defs[0xB0].text, ",W]");
+return true;
 }
 
 /*****************************************************************************/
@@ -604,7 +529,7 @@ switch (M)                              /* which mode is this ?              */
       if (bSetLabel)
         {
         W = (uint16_t)PhaseInner(W, PC);
-        AddLabel(W, mnemo[MI].memType, "", true);
+        AddLabel(W, mnemoTbl[MI].memType, "", true);
         }
       }
     PC++;
@@ -632,7 +557,7 @@ switch (M)                              /* which mode is this ?              */
     if (bSetLabel)
       {
       W = (uint16_t)PhaseInner(GetUWord(PC), PC);
-      AddLabel(W, mnemo[MI].memType, "", true);
+      AddLabel(W, mnemoTbl[MI].memType, "", true);
       }
     PC += 2;
     break;
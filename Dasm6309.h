@@ -156,14 +156,17 @@ class Dasm6309 : public Dasm6809
       mnemo6309_count
       };
 
-    static uint8_t h6309_codes[512];
-    static uint8_t h6309_codes10[512];
-    static uint8_t h6309_codes11[512];
+    static OpDef h6309_codes[256];
+    static OpDef h6309_codes10[256];
+    static OpDef h6309_codes11[256];
     static OpCode opcodes[mnemo6309_count - mnemo6809_count];
-
-  protected:
-    virtual addr_t IndexParse(int MI, addr_t pc);
-    virtual string IndexString(addr_t &pc);
+    static OpCode h6309_mnemo[mnemo6309_count];
+    static OpDesc h6309_descs[3 * 256];
+    static bool bDescsBuilt;
+    static bool SetupMnemonics(OpCode *mnemos);
+    static IndexDef h6309_index[256];
+    static bool bIndexDefsBuilt;
+    static bool BuildIndexDefs(IndexDef *defs);
   };
 
 #endif // __Dasm6309_h_defined__
@@ -39,15 +39,15 @@ return pDasm;
 }
 
 /*****************************************************************************/
-/* Auto-registration                                                         */
+/* RegisterDasm6800 : register the 6800 disassemblers                        */
 /*****************************************************************************/
 
-static bool bRegistered[] =
-  {
-  RegisterDisassembler("6800", Create6800),
-  RegisterDisassembler("6802", Create6800),
-  RegisterDisassembler("6808", Create6800),
-  };
+bool RegisterDasm6800()
+{
+return RegisterDisassembler("6800", Create6800) &&
+       RegisterDisassembler("6802", Create6800) &&
+       RegisterDisassembler("6808", Create6800);
+}
 
 
 /*===========================================================================*/
@@ -58,7 +58,7 @@ static bool bRegistered[] =
 /* m6800_codes : table of all 6800 instruction bytes and types               */
 /*****************************************************************************/
 
-uint8_t Dasm6800::m6800_codes[512] =
+Dasm6800::OpDef Dasm6800::m6800_codes[256] =
   {
   _ill  ,_nom,   _nop  ,_imp,   _ill  ,_nom,   _ill  ,_nom,     /* 00..03 */
   _ill  ,_nom,   _ill  ,_nom,   _tap  ,_imp,   _tpa  ,_imp,     /* 04..07 */
@@ -252,13 +252,65 @@ OpCode Dasm6800::opcodes[mnemo6800_count] =
     { "LSRD",  Data },                  /* _lsrd                             */
   };
 
+/*****************************************************************************/
+/* m6800_descs : 6800 instruction descriptors                                */
+/*****************************************************************************/
+
+Dasm6800::OpDesc Dasm6800::m6800_descs[256];
+bool Dasm6800::bDescsBuilt = Dasm6800::BuildDescs(m6800_descs, opcodes, m6800_codes);
+
+/*****************************************************************************/
+/* SetupMnemonics : fill a variant's mnemonics table with the 6800 part      */
+/*****************************************************************************/
+
+bool Dasm6800::SetupMnemonics(OpCode *mnemos)
+{
+for (int i = 0; i < mnemo6800_count; i++)
+  mnemos[i] = opcodes[i];
+return true;
+}
+
+/*****************************************************************************/
+/* BuildDescs : set up a variant's instruction descriptors                   */
+/*****************************************************************************/
+
+// This is done once at program startup from the variant's page tables and
+// its complete mnemonics table, so that decoding an instruction only
+// needs one table lookup per opcode byte.
+
+bool Dasm6800::BuildDescs
+    (
+    OpDesc *descs,
+    const OpCode *mnemos,
+    const OpDef *codes,
+    const OpDef *codes10,
+    const OpDef *codes11
+    )
+{
+const OpDef *pages[3] = { codes, codes10, codes11 };
+for (int page = 0; page < 3; page++)
+  {
+  if (!pages[page])
+    continue;
+  for (int T = 0; T < 256; T++)
+    {
+    OpDesc &desc = descs[page * 256 + T];
+    desc.mi = pages[page][T].mi;
+    desc.mode = pages[page][T].mode;
+    desc.mne = mnemos[desc.mi].mne;
+    }
+  }
+return true;
+}
+
 /*****************************************************************************/
 /* Dasm6800 : constructor                                                    */
 /*****************************************************************************/
 
 Dasm6800::Dasm6800(void)
 {
-codes = m6800_codes;
+descs = m6800_descs;
+mnemoTbl = opcodes;
 useConvenience = true;
 showIndexedModeZeroOperand = false;
 useFCC = true;
@@ -273,10 +325,6 @@ closeCC = false;
 commentStart = "*";
 #endif
 
-mnemo.resize(mnemo6800_count);          /* set up mnemonics table            */
-for (int i = 0; i < mnemo6800_count; i++)
-  mnemo[i] = opcodes[i];
-
 // set up options table
 // class uses one generic option setter/getter pair (not mandatory)
 AddOption("conv", "{off|on}\tUse convenience macros",
@@ -554,24 +602,56 @@ else
 if (disp == MemAttribute::DefaultDisplay)
   disp = defaultDisplay;
 
+if ((nDigits == 2) && (value <= 0xff))  /* if byte value, use prerendered    */
+  {
+  ByteFormat fmt;
+  switch (disp)
+    {
+    case MemAttribute::Char :
+      fmt = closeCC ? bfCharClosed : bfChar;
+      break;
+    case MemAttribute::Binary :
+      fmt = bfBinary;
+      break;
+    case MemAttribute::Hex :
+      fmt = bfHex;
+      break;
+    case MemAttribute::Octal :
+      fmt = bfOctal;
+      break;
+    default :
+      fmt = bSigned ? bfSigned : bfDecimal;
+      break;
+    }
+  return byteStrings[fmt][value];
+  }
+
 if ((nDigits == 2) &&                   /* if 2-digit value                  */
     (disp == MemAttribute::Char))       /* and character output requested    */
   {
   value &= 0xff;
   if (isprint(value))
-    s = sformat("'%c%s", value, closeCC ? "'" : "");
+    {
+    s = '\'';
+    s += (char)value;
+    if (closeCC)
+      s += '\'';
+    }
   else
-    s = sformat("$%02x", value);
+    AppendHex(s = '$', value, 2, false);
   }
 else if (disp == MemAttribute::Binary)  /* if a binary                       */
   {
-  int nBit;
-
   nDigits *= 4;                         /* convert from digits to bits       */
   s = '%';                              /* prepare a binary value            */
-                                        /* now do for all bits               */
-  for (nBit = nDigits - 1; nBit >= 0; nBit--) 
-    s.push_back('0' + (!!(value & (1 << nBit))));
+  AppendBin(s, value, nDigits);         /* now do for all bits               */
+  }
+else if ((disp == MemAttribute::Hex) &&  /* if hex in whole bytes             */
+         nDigits >= 2 && nDigits <= 8 && !(nDigits & 1))
+  {
+  s = '$';                              /* compose from prerendered bytes    */
+  for (int i = nDigits / 2 - 1; i >= 0; i--)
+    s += byteStrings[bfHex][(value >> (i * 8)) & 0xff] + 1;
   }
 else if (disp == MemAttribute::Hex)     /* if hex                            */
   {
@@ -579,10 +659,10 @@ else if (disp == MemAttribute::Hex)     /* if hex                            */
   for (int i = 0; i < nDigits; i++)
     mask |= (0x0f << (i * 4));
   value &= mask;
-  s = sformat("$%0*X", nDigits, value); /* prepare a hex value               */
+  AppendHex(s = '$', value, nDigits);   /* prepare a hex value               */
   }
 else if (disp == MemAttribute::Octal)   /* if octal display                  */
-  s = sformat("@%0*o", (nDigits * 4) + 2 / 3, value);
+  AppendOct(s = '@', value, (nDigits * 4) + 2 / 3);
 else                                    /* otherwise                         */
   {
   if (bSigned)
@@ -591,7 +671,7 @@ else                                    /* otherwise                         */
     if (nDigits == 2) sval = (int32_t)((int8_t)value);
     else if (nDigits == 4) sval = (int32_t)((int16_t)value);
     else sval = (int32_t)value;
-    s = sformat("%d", sval);            /* prepare signed decimal value      */
+    AppendSigned(s, sval);              /* prepare signed decimal value      */
     }
   else
     {
@@ -599,7 +679,7 @@ else                                    /* otherwise                         */
     for (int i = 0; i < nDigits; i++)
       mask |= (0x0f << (i * 4));
     value &= mask;
-    s = sformat("%u", value);           /* prepare unsigned decimal value    */
+    AppendDec(s, value);                /* prepare unsigned decimal value    */
     }
   }
 return s;                               /* pass back generated string        */
@@ -686,10 +766,10 @@ addr_t Dasm6800::FetchInstructionDetails
     )
 {
 O = T = GetUByte(PC++);
-W = (uint16_t)(T * 2);
-MI = T = codes[W++];
-I = mnemo[T].mne;
-M = codes[W];
+const OpDesc &op = descs[T];
+MI = T = op.mi;
+M = op.mode;
+I = op.mne;
 if (smnemo)
   *smnemo = I;
 return PC;
@@ -744,7 +824,7 @@ switch (M)                              /* which mode is this ?              */
     if (bSetLabel)
       {
       W = (uint16_t)PhaseInner(W, PC);
-      AddLabel(W, mnemo[MI].memType, "", true);
+      AddLabel(W, mnemoTbl[MI].memType, "", true);
       }
     PC += 2;
     break;
@@ -759,7 +839,7 @@ switch (M)                              /* which mode is this ?              */
       {
       W = T;  // on 6800, dp=0
       W = (uint16_t)PhaseInner(W, PC);
-      AddLabel(W, mnemo[MI].memType, "", true);
+      AddLabel(W, mnemoTbl[MI].memType, "", true);
       }
     PC++;
     break;
@@ -774,7 +854,7 @@ switch (M)                              /* which mode is this ?              */
       {
       W = GetUWord(PC);
       W = (uint16_t)PhaseInner(W, PC);
-      AddLabel(W, mnemo[MI].memType, "", true);
+      AddLabel(W, mnemoTbl[MI].memType, "", true);
       }
     PC += 2;
     break;
@@ -795,7 +875,7 @@ switch (M)                              /* which mode is this ?              */
     if (bSetLabel)
       {
       W = (uint16_t)DephaseOuter(W, PC - 1);
-      AddLabel(W, mnemo[MI].memType, "", true);
+      AddLabel(W, mnemoTbl[MI].memType, "", true);
       }
     break;
     
@@ -970,10 +1050,10 @@ switch (M)                              /* which mode is this?               */
       switch ((uint16_t)(O << 8) | GetUByte(PC))
         {
         case 0x4456 :                   /* LSRA + RORB -> LSRD               */
-          smnemo = mnemo[_lsrd].mne; PC++;
+          smnemo = mnemoTbl[_lsrd].mne; PC++;
           break;
         case 0x5849 :                   /* ASLB + ROLA -> ASLD               */
-          smnemo = mnemo[_asld].mne; PC++;
+          smnemo = mnemoTbl[_asld].mne; PC++;
           break;
         }
       }
@@ -67,13 +67,13 @@ class Dasm6800 :
     // return code pointer size in bytes
     virtual int GetCodePtrSize() { return 2; }
     // return highest possible code address
-    virtual caddr_t GetHighestCodeAddr() { return 0xffff; }
+    virtual codeaddr_t GetHighestCodeAddr() { return 0xffff; }
     // return data bits
     virtual int GetDataBits() { return 8; }
     // return data pointer size in bytes
     virtual int GetDataPtrSize() { return 2; }
     // return highest possible data address
-    virtual daddr_t GetHighestDataAddr() { return 0xffff; }
+    virtual dataaddr_t GetHighestDataAddr() { return 0xffff; }
 
   // Options handler
   protected:
@@ -106,7 +106,7 @@ class Dasm6800 :
     virtual bool String2Number(string s, addr_t &value);
     virtual string Number2String(addr_t value, int nDigits, addr_t addr, int bus = BusCode);
     virtual string Address2String(addr_t addr, int bus = BusCode)
-      { return sformat("$%04X", addr); }
+      { string s("$"); AppendHex(s, addr, 4); return s; }
     virtual addr_t FetchInstructionDetails(addr_t PC, uint8_t &O, uint8_t &T, uint8_t &M, uint16_t &W, int &MI, const char *&I, string *smnemo = NULL);
 
   protected:
@@ -243,9 +243,31 @@ class Dasm6800 :
       mnemo6800_count
       };
 
-    static uint8_t m6800_codes[512];
+    // instruction table entry
+    struct OpDef
+      {
+      uint8_t mi;                       /* mnemonic index                    */
+      uint8_t mode;                     /* addressing mode                   */
+      };
+
+    // decoded instruction descriptor; each CPU variant builds one flat
+    // table of these at startup, indexed by page * 256 + opcode, where
+    // pages 1 and 2 hold the $10 / $11 prefixed 6809 and 6309 opcodes
+    struct OpDesc
+      {
+      const char *mne;                  /* mnemonic                          */
+      uint8_t mi;                       /* mnemonic index                    */
+      uint8_t mode;                     /* addressing mode                   */
+      };
+
+    static OpDef m6800_codes[256];
+    static OpDesc m6800_descs[256];
+    static bool bDescsBuilt;
+    static bool SetupMnemonics(OpCode *mnemos);
+    static bool BuildDescs(OpDesc *descs, const OpCode *mnemos, const OpDef *codes, const OpDef *codes10 = NULL, const OpDef *codes11 = NULL);
 
-    uint8_t *codes;
+    const OpDesc *descs;                /* variant's instruction descriptors */
+    const OpCode *mnemoTbl;             /* variant's mnemonics               */
     static char *bit_r[];
     static char *block_r[];
     static OpCode opcodes[mnemo6800_count];
@@ -38,15 +38,15 @@ return pDasm;
 }
 
 /*****************************************************************************/
-/* Auto-registration                                                         */
+/* RegisterDasm68000 : register the 68000 disassembler                       */
 /*****************************************************************************/
 
-static bool bRegistered[] =
-  {
-  RegisterDisassembler("68000", Create68000),
-  // RegisterDisassembler("68k",   Create68000),
-  // RegisterDisassembler("68008", Create68000),
-  };
+bool RegisterDasm68000()
+{
+return RegisterDisassembler("68000", Create68000) /* &&
+       RegisterDisassembler("68k",   Create68000) &&
+       RegisterDisassembler("68008", Create68000) */;
+}
 
 /*===========================================================================*/
 /* Dasm680000 class members                                                  */
@@ -200,6 +200,85 @@ Dasm68000::OpDef Dasm68000::OpTable[optblSize] =
     { _ill,     0x0000, 0x0000, optype_unknown }
   };
 
+/*****************************************************************************/
+/* otIndex : op code to OpTable index translation                            */
+/*****************************************************************************/
+
+uint8_t Dasm68000::otIndex[65536];
+bool Dasm68000::bOtIndexBuilt = Dasm68000::BuildOtIndex();
+
+/*****************************************************************************/
+/* ParseOptypes / DisassembleOptypes : op type handlers                      */
+/*****************************************************************************/
+
+Dasm68000::PParseOptype Dasm68000::ParseOptypes[OpType68000_count] =
+  {
+  NULL,                                 /* optype_unknown                    */
+  &Dasm68000::ParseOptype01,
+  &Dasm68000::ParseOptype02,
+  &Dasm68000::ParseOptype03,
+  &Dasm68000::ParseOptype04,
+  &Dasm68000::ParseOptype05,
+  &Dasm68000::ParseOptype06,
+  &Dasm68000::ParseOptype07,
+  &Dasm68000::ParseOptype08,
+  &Dasm68000::ParseOptype09,
+  &Dasm68000::ParseOptype10,
+  &Dasm68000::ParseOptype11,
+  &Dasm68000::ParseOptype12,
+  &Dasm68000::ParseOptype13,
+  &Dasm68000::ParseOptype14,
+  &Dasm68000::ParseOptype15,
+  &Dasm68000::ParseOptype16,
+  &Dasm68000::ParseOptype17,
+  &Dasm68000::ParseOptype18,
+  &Dasm68000::ParseOptype19,
+  &Dasm68000::ParseOptype20,
+  &Dasm68000::ParseOptype21,
+  &Dasm68000::ParseOptype22,
+  &Dasm68000::ParseOptype23,
+  &Dasm68000::ParseOptype24,
+  &Dasm68000::ParseOptype25,
+  &Dasm68000::ParseOptype26,
+  &Dasm68000::ParseOptype27,
+  &Dasm68000::ParseOptype28,
+  &Dasm68000::ParseOptype29
+  };
+
+Dasm68000::PDisassembleOptype Dasm68000::DisassembleOptypes[OpType68000_count] =
+  {
+  NULL,                                 /* optype_unknown                    */
+  &Dasm68000::DisassembleOptype01,
+  &Dasm68000::DisassembleOptype02,
+  &Dasm68000::DisassembleOptype03,
+  &Dasm68000::DisassembleOptype04,
+  &Dasm68000::DisassembleOptype05,
+  &Dasm68000::DisassembleOptype06,
+  &Dasm68000::DisassembleOptype07,
+  &Dasm68000::DisassembleOptype08,
+  &Dasm68000::DisassembleOptype09,
+  &Dasm68000::DisassembleOptype10,
+  &Dasm68000::DisassembleOptype11,
+  &Dasm68000::DisassembleOptype12,
+  &Dasm68000::DisassembleOptype13,
+  &Dasm68000::DisassembleOptype14,
+  &Dasm68000::DisassembleOptype15,
+  &Dasm68000::DisassembleOptype16,
+  &Dasm68000::DisassembleOptype17,
+  &Dasm68000::DisassembleOptype18,
+  &Dasm68000::DisassembleOptype19,
+  &Dasm68000::DisassembleOptype20,
+  &Dasm68000::DisassembleOptype21,
+  &Dasm68000::DisassembleOptype22,
+  &Dasm68000::DisassembleOptype23,
+  &Dasm68000::DisassembleOptype24,
+  &Dasm68000::DisassembleOptype25,
+  &Dasm68000::DisassembleOptype26,
+  &Dasm68000::DisassembleOptype27,
+  &Dasm68000::DisassembleOptype28,
+  &Dasm68000::DisassembleOptype29
+  };
+
 /*****************************************************************************/
 /* opcodes : 68000 opcodes array for initialization                          */
 /*****************************************************************************/
@@ -342,26 +421,10 @@ closeCC = true;
 showInstTypes = false;
 commentStart = ";";
 
-int i, j;
+int i;
 mnemo.resize(mnemo68000_count);         /* set up mnemonics table            */
 for (i = 0; i < mnemo68000_count; i++)
   mnemo[i] = opcodes[i];
-                                        /* set up instruction table          */
-otIndex = new uint8_t[65536];
-for (i = optblSize - 1; i > 0; i--)
-  if (OpTable[i - 1].ot != optype_unknown)
-    break;
-memset(otIndex, i, 65536);
-for (--i; i >= 0; i--)
-  {
-  int nStart = OpTable[i].op_code;
-  int nEnd = (nStart | ~OpTable[i].mask) & 0xffff;
-  for (j = nStart; j <= nEnd; j++)
-    {
-    if ((j & OpTable[i].mask) == OpTable[i].op_code)
-      otIndex[j] = (unsigned char)i;
-    }
-  }
 
 AddOption("gas", "{off|on}\tCreate GNU Assembler compatible output",
           static_cast<PSetter>(&Dasm68000::Set68000Option),
@@ -386,8 +449,38 @@ AddOption("shit", "{off|on}\tshow instruction types",
 
 Dasm68000::~Dasm68000(void)
 {
-if (otIndex)
-  delete[] otIndex;
+}
+
+/*****************************************************************************/
+/* BuildOtIndex : set up the op code to OpTable index translation            */
+/*****************************************************************************/
+
+// This is done once at program startup for all Dasm68000 instances, so
+// constructing a disassembler costs nothing. Instead of testing all 64K
+// op codes against each table entry, only the op codes that an entry can
+// match are visited, by enumerating all values of its variable bits.
+
+bool Dasm68000::BuildOtIndex()
+{
+int i;
+for (i = optblSize - 1; i > 0; i--)
+  if (OpTable[i - 1].ot != optype_unknown)
+    break;
+memset(otIndex, i, sizeof(otIndex));
+for (--i; i >= 0; i--)                  /* earlier entries take precedence   */
+  {
+  uint16_t code = OpTable[i].op_code;
+  uint16_t vbits = (uint16_t)~OpTable[i].mask;
+  if (code & vbits)                     /* can't match anything              */
+    continue;
+  uint16_t sub = 0;
+  do
+    {
+    otIndex[code | sub] = (uint8_t)i;
+    sub = (uint16_t)((sub - vbits) & vbits);
+    } while (sub);
+  }
+return true;
 }
 
 /*****************************************************************************/
@@ -513,24 +606,56 @@ else
 if (disp == MemAttribute::DefaultDisplay)
   disp = defaultDisplay;
 
+if ((nDigits == 2) && (value <= 0xff))  /* if byte value, use prerendered    */
+  {
+  ByteFormat fmt;
+  switch (disp)
+    {
+    case MemAttribute::Char :
+      fmt = closeCC ? bfCharClosed : bfChar;
+      break;
+    case MemAttribute::Binary :
+      fmt = bfBinary;
+      break;
+    case MemAttribute::Hex :
+      fmt = bfHex;
+      break;
+    case MemAttribute::Octal :
+      fmt = bfOctal;
+      break;
+    default :
+      fmt = bSigned ? bfSigned : bfDecimal;
+      break;
+    }
+  return byteStrings[fmt][value];
+  }
+
 if ((nDigits == 2) &&                   /* if 2-digit value                  */
     (disp == MemAttribute::Char))       /* and character output requested    */
   {
   value &= 0xff;
   if (isprint(value))
-    s = sformat("'%c%s", value, closeCC ? "'" : "");
+    {
+    s = '\'';
+    s += (char)value;
+    if (closeCC)
+      s += '\'';
+    }
   else
-    s = sformat("$%02x", value);
+    AppendHex(s = '$', value, 2, false);
   }
 else if (disp == MemAttribute::Binary)  /* if a binary                       */
   {
-  int nBit;
-
   nDigits *= 4;                         /* convert from digits to bits       */
   s = '%';                              /* prepare a binary value            */
-                                        /* now do for all bits               */
-  for (nBit = nDigits - 1; nBit >= 0; nBit--) 
-    s.push_back('0' + (!!(value & (1 << nBit))));
+  AppendBin(s, value, nDigits);         /* now do for all bits               */
+  }
+else if ((disp == MemAttribute::Hex) &&  /* if hex in whole bytes             */
+         nDigits >= 2 && nDigits <= 8 && !(nDigits & 1))
+  {
+  s = '$';                              /* compose from prerendered bytes    */
+  for (int i = nDigits / 2 - 1; i >= 0; i--)
+    s += byteStrings[bfHex][(value >> (i * 8)) & 0xff] + 1;
   }
 else if (disp == MemAttribute::Hex)     /* if hex                            */
   {
@@ -538,10 +663,10 @@ else if (disp == MemAttribute::Hex)     /* if hex                            */
   for (int i = 0; i < nDigits; i++)
     mask |= (0x0f << (i * 4));
   value &= mask;
-  s = sformat("$%0*X", nDigits, value); /* prepare a hex value               */
+  AppendHex(s = '$', value, nDigits);   /* prepare a hex value               */
   }
 else if (disp == MemAttribute::Octal)   /* if octal display                  */
-  s = sformat("@%0*o", (nDigits * 4) + 2 / 3, value);
+  AppendOct(s = '@', value, (nDigits * 4) + 2 / 3);
 else                                    /* otherwise                         */
   {
   if (bSigned)
@@ -550,7 +675,7 @@ else                                    /* otherwise                         */
     if (nDigits == 2) sval = (int32_t)((int8_t)value);
     else if (nDigits == 4) sval = (int32_t)((int16_t)value);
     else sval = (int32_t)value;
-    s = sformat("%d", sval);            /* prepare signed decimal value      */
+    AppendSigned(s, sval);              /* prepare signed decimal value      */
     }
   else
     {
@@ -558,7 +683,7 @@ else                                    /* otherwise                         */
     for (int i = 0; i < nDigits; i++)
       mask |= (0x0f << (i * 4));
     value &= mask;
-    s = sformat("%u", value);           /* prepare unsigned decimal value    */
+    AppendDec(s, value);                /* prepare unsigned decimal value    */
     }
   }
 return s;                               /* pass back generated string        */
@@ -659,101 +784,99 @@ addr_t Dasm68000::ParseCode
 uint16_t code = GetUWord(addr /*, bus*/);
 int i = otIndex[code];
 addr_t len = 2;                         /* default to 2 bytes length         */
-switch (OpTable[i].ot)                  /* parse according to op type        */
+PParseOptype pParse = ParseOptypes[OpTable[i].ot];
+if (pParse)                             /* parse according to op type        */
+  len = (this->*pParse)(addr, addr + 2, code, i) - addr;
+else                                    /* not a valid instruction ?         */
+  SetInvalidInstruction(addr, 2);       /* mark it as such                   */
+
+return len;
+}
+
+/*****************************************************************************/
+/* eaKinds : EA kind for each combination of mode and register bits          */
+/*****************************************************************************/
+
+uint8_t Dasm68000::eaKinds[64] =
   {
-  case optype_01 :
-    len = ParseOptype01(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_02 :
-    len = ParseOptype02(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_03 :
-    len = ParseOptype03(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_04 :
-    len = ParseOptype04(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_05 :
-    len = ParseOptype05(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_06 :
-    len = ParseOptype06(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_07 :
-    len = ParseOptype07(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_08 :
-    len = ParseOptype08(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_09 :
-    len = ParseOptype09(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_10 :
-    len = ParseOptype10(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_11 :
-    len = ParseOptype11(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_12 :
-    len = ParseOptype12(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_13 :
-    len = ParseOptype13(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_14 :
-    len = ParseOptype14(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_15 :
-    len = ParseOptype15(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_16 :
-    len = ParseOptype16(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_17 :
-    len = ParseOptype17(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_18 :
-    len = ParseOptype18(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_19 :
-    len = ParseOptype19(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_20 :
-    len = ParseOptype20(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_21 :
-    len = ParseOptype21(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_22 :
-    len = ParseOptype22(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_23 :
-    len = ParseOptype23(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_24 :
-    len = ParseOptype24(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_25 :
-    len = ParseOptype25(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_26 :
-    len = ParseOptype26(addr, addr + 2, code, i) - addr;
-    break;
-  case optype_27 :
-    len = ParseOptype27(addr, addr + 2, code, i) - addr;
+  eaDReg,     eaDReg,     eaDReg,     eaDReg,                   /* mode 0 */
+  eaDReg,     eaDReg,     eaDReg,     eaDReg,
+  eaAReg,     eaAReg,     eaAReg,     eaAReg,                   /* mode 1 */
+  eaAReg,     eaAReg,     eaAReg,     eaAReg,
+  eaAInd,     eaAInd,     eaAInd,     eaAInd,                   /* mode 2 */
+  eaAInd,     eaAInd,     eaAInd,     eaAInd,
+  eaAPostInc, eaAPostInc, eaAPostInc, eaAPostInc,               /* mode 3 */
+  eaAPostInc, eaAPostInc, eaAPostInc, eaAPostInc,
+  eaAPreDec,  eaAPreDec,  eaAPreDec,  eaAPreDec,                /* mode 4 */
+  eaAPreDec,  eaAPreDec,  eaAPreDec,  eaAPreDec,
+  eaADisp,    eaADisp,    eaADisp,    eaADisp,                  /* mode 5 */
+  eaADisp,    eaADisp,    eaADisp,    eaADisp,
+  eaAIndex,   eaAIndex,   eaAIndex,   eaAIndex,                 /* mode 6 */
+  eaAIndex,   eaAIndex,   eaAIndex,   eaAIndex,
+  eaAbsShort, eaAbsLong,  eaPCDisp,   eaPCIndex,                /* mode 7 */
+  eaImmediate,eaInvalid,  eaInvalid,  eaInvalid,
+  };
+
+/*****************************************************************************/
+/* DecodeEffectiveAddress : decode the EA part of an instruction             */
+/*****************************************************************************/
+
+// This fetches everything the EA needs from the extension words, so that
+// parsing and disassembly see exactly the same operand.
+
+addr_t Dasm68000::DecodeEffectiveAddress
+    (
+    addr_t addr,                        /* current address                   */
+    uint16_t ea,
+    int op_mode,
+    EffectiveAddress &e                 /* destination                       */
+    )
+{
+e.kind = eaKinds[ea & 0x3f];
+e.reg = (uint8_t)(ea & 0x07);
+e.ext = addr;
+e.value = 0;
+switch (e.kind)
+  {
+  case eaADisp:                         /* address with displacement         */
+  case eaAbsShort:                      /* absolute short                    */
+  case eaPCDisp:                        /* program counter with displacement */
+    e.value = GetSWord(addr);
+    addr += 2;
     break;
-  case optype_28 :
-    len = ParseOptype28(addr, addr + 2, code, i) - addr;
+  case eaAIndex:                        /* indexed address with displacement */
+  case eaPCIndex:
+    {
+    uint16_t ext = GetUWord(addr);
+    e.index_reg = (uint8_t)((ext >> 12) & 0x07);
+    e.index_areg = !!(ext & 0x8000);
+    e.value = (signed char)(ext & 0xff);
+    addr += 2;
+    }
     break;
-  case optype_29 :
-    len = ParseOptype29(addr, addr + 2, code, i) - addr;
+  case eaAbsLong:                       /* absolute long                     */
+    e.value = GetSDWord(addr);
+    addr += 4;
     break;
-  default :                             /* not a valid instruction ?         */
-    SetInvalidInstruction(addr, 2);     /* mark it as such                   */
+  case eaImmediate:                     /* immediate data                    */
+    if (op_mode == LONG_SIZE)
+      {
+      e.value = GetSDWord(addr);
+      addr += 4;
+      }
+    else if (op_mode == WORD_SIZE)
+      {
+      e.value = GetSWord(addr);
+      addr += 2;
+      }
+    else if (op_mode == BYTE_SIZE)
+      {
+      e.value = (char)(GetSWord(addr) & 0xff);
+      addr += 2;
+      }
     break;
   }
-
-return len;
+return addr;
 }
 
 /*****************************************************************************/
@@ -769,152 +892,54 @@ addr_t Dasm68000::ParseEffectiveAddress
     int op_mode
     )
 {
-int32_t displacement;
-int16_t short_adr;
-int index_reg;
-int index_reg_ind;
-int index_size;
+EffectiveAddress e;
 int32_t a1;
 MemoryType mt = mnemo[OpTable[index].mnemo].memType;
 Label *lbl;
 
-int mode = (ea & 0x38) >> 3;
-int reg = ea & 0x7;
-switch(mode)
+addr = DecodeEffectiveAddress(addr, ea, op_mode, e);
+switch (e.kind)
   {
-  case 0:                               /* one of the data registers         */
-  case 1:                               /* one of the address registers      */
-  case 2:                               /* indirect address                  */
-    // sprintf(s,"(%s)",adr_regs[reg]);
-  case 3:                               /* indirect address with increment   */
-    // sprintf(s,"(%s)+",adr_regs[reg]);
-  case 4:                               /* indirect address with decrement   */
-    // sprintf(s,"-(%s)",adr_regs[reg]);
-    break;
-  case 5:                               /* address with displacement         */
-    displacement = GetSWord(addr);
-    addr += 2;
-    // sprintf(s,"$%x(%s)",displacement,adr_regs[reg]);
-    break;
-  case 6:                               /* indexed address with displacement */
-    displacement = GetUWord(addr);
-    addr += 2;
-    index_reg = (displacement & 0x7000) >> 12;
-    index_reg_ind = (displacement & 0x8000)>> 15;
-    index_size = (displacement & 0x8000) >> 11;
-    displacement = (signed char)(displacement & 0xff);
-#if 0
-    if (index_size)
+  case eaAbsShort:                      /* absolute short                    */
+    SetCellSize(e.ext, 2);
+    lbl = FindLabel((uint16_t)e.value, mt);
+    if (lbl)
+      lbl->SetUsed();
+    a1 = PhaseInner((uint16_t)e.value, instaddr);
+    AddLabel(a1, mt, "", true);
+    break;
+  case eaAbsLong:                       /* absolute long                     */
+    SetCellSize(e.ext, 4);
+    lbl = FindLabel(e.value, mt);
+    if (lbl)
+      lbl->SetUsed();
+    a1 = PhaseInner(e.value, instaddr);
+    if ((addr_t)a1 <= GetHighestCodeAddr())
+      AddLabel(a1, mt, "", true);
+    break;
+  case eaPCDisp:                        /* program counter with displacement */
+    SetCellSize(e.ext, 2);
+    a1 = (int32_t)e.ext + e.value;
+    lbl = FindLabel(a1, mt);
+    if (lbl)
+      lbl->SetUsed();
+    a1 = PhaseInner(a1, instaddr);
+    AddLabel(a1, mt, "", true);
+    break;
+  case eaImmediate:                     /* immediate data                    */
+    if (op_mode == LONG_SIZE)
       {
-      s1 = ".L";
+      lbl = FindLabel(e.value, mt);
+      if (lbl)
+        lbl->SetUsed();
+      // this MIGHT be a label, but more likely it's constant data,
+      // so don't automatically assign a label
       }
-    else
-      {
-      s1 = ".W";
-      }
-    if(index_reg_ind)
-      {
-      /*	address reg is index reg	*/
-      sprintf(s,"$%x(%s,%s%s)",displacement,adr_regs[reg],adr_regs[index_reg],s1);
-      }
-    else
-      {
-      /*	data reg is index reg	*/
-      sprintf(s,"$%x(%s,%s%s)",displacement,adr_regs[reg],data_regs[index_reg],s1);
-      }
-#endif
-    break;
-  case 7:
-    switch (reg)
-      {
-      case 0:		/*	absolute short	*/
-        short_adr = GetSWord(addr);
-        SetCellSize(addr, 2);
-        addr += 2;
-        // sprintf(s,"$%lx.S",(long)short_adr);
-        lbl = FindLabel((uint16_t)short_adr, mt);
-        if (lbl)
-          lbl->SetUsed();
-        a1 = PhaseInner((uint16_t)short_adr, instaddr);
-        AddLabel(a1, mt, "", true);
-        break;
-      case 1:		/*	absolute long	*/
-        a1 = GetSDWord(addr);
-        SetCellSize(addr, 4);
-        addr += 4;
-        lbl = FindLabel(a1, mt);
-        if (lbl)
-          lbl->SetUsed();
-        a1 = PhaseInner(a1, instaddr);
-        if ((addr_t)a1 <= GetHighestCodeAddr())
-          AddLabel(a1, mt, "", true);
-        break;
-      case 2:	/*	program counter with displacement	*/
-        displacement = GetSWord(addr);
-        SetCellSize(addr, 2);
-        a1 = (int32_t)addr + displacement;
-        addr += 2;
-        // sprintf(s,"$%lx(PC)",a1);
-        lbl = FindLabel(a1, mt);
-        if (lbl)
-          lbl->SetUsed();
-        a1 = PhaseInner(a1, instaddr);
-        AddLabel(a1, mt, "", true);
-        break;
-      case 3:
-        displacement = GetUWord(addr);
-        a1 = (int32_t)addr + (char)(displacement & 0xff);
-        addr += 2;
-        index_reg = (displacement >> 12) & 0x07;
-#if 0
-        if (displacement & 0x8000)
-          /*	address reg is index reg	*/
-          sprintf(s,"$%lx(PC,%s%s)",a1,adr_regs[index_reg],".L");
-        else
-          /*	data reg is index reg	*/
-          sprintf(s,"$%lx(PC,%s%s)",a1,data_regs[index_reg],".W");
-#endif
-        break;
-      case 4:  // Immediate Data
-        // This one is tough
-        if (op_mode == LONG_SIZE)
-          {
-          a1 = GetSDWord(addr);
-          addr += 4;
-          lbl = FindLabel(a1, mt);
-          if (lbl)
-            lbl->SetUsed();
-#if 0
-          // this MIGHT be a label, but more likely it's constant data,
-          // so don't automatically assign a label
-          a1 = PhaseInner(a1, addr - 6);
-          AddLabel(a1, mt, "", true);
-#endif
-          }
-        else if (op_mode == WORD_SIZE || op_mode == BYTE_SIZE)
-          {
-          displacement = GetSWord(addr);
-          addr += 2;
-#if 0
-          if (op_mode == WORD_SIZE)
-            sprintf(s,"#$%x.W",displacement);
-          else if (op_mode == BYTE_SIZE)
-            {
-            displacement = (char)(displacement & 0xff);
-            sprintf(s,"#$%x.B",displacement);
-            }
-#endif
-          }
-        break;
-      default :                         /* anything else?                    */
-        SetInvalidInstruction(instaddr, 2);
-        break;
-      }	/*	end of switch reg	*/
     break;
-  default :                             /* anything else ?                   */
+  case eaInvalid:                       /* anything else?                    */
     SetInvalidInstruction(instaddr, 2);
     break;
-  }	/*	end of switch mode	*/
+  }
 return addr;
 }
 
@@ -1582,98 +1607,9 @@ uint16_t code = GetUWord(addr /*, bus*/);
 int i = otIndex[code];
 addr_t len = 2;                         /* default to 2 bytes length         */
 smnemo = mnemo[OpTable[i].mnemo].mne;   /* initialize mnemonic               */
-switch (OpTable[i].ot)                  /* parse according to op type        */
-  {
-  case optype_01 :
-    len = DisassembleOptype01(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_02 :
-    len = DisassembleOptype02(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_03 :
-    len = DisassembleOptype03(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_04 :
-    len = DisassembleOptype04(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_05 :
-    len = DisassembleOptype05(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_06 :
-    len = DisassembleOptype06(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_07 :
-    len = DisassembleOptype07(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_08 :
-    len = DisassembleOptype08(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_09 :
-    len = DisassembleOptype09(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_10 :
-    len = DisassembleOptype10(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_11 :
-    len = DisassembleOptype11(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_12 :
-    len = DisassembleOptype12(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_13 :
-    len = DisassembleOptype13(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_14 :
-    len = DisassembleOptype14(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_15 :
-    len = DisassembleOptype15(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_16 :
-    len = DisassembleOptype16(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_17 :
-    len = DisassembleOptype17(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_18 :
-    len = DisassembleOptype18(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_19 :
-    len = DisassembleOptype19(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_20 :
-    len = DisassembleOptype20(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_21 :
-    len = DisassembleOptype21(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_22 :
-    len = DisassembleOptype22(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_23 :
-    len = DisassembleOptype23(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_24 :
-    len = DisassembleOptype24(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_25 :
-    len = DisassembleOptype25(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_26 :
-    len = DisassembleOptype26(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_27 :
-    len = DisassembleOptype27(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_28 :
-    len = DisassembleOptype28(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  case optype_29 :
-    len = DisassembleOptype29(addr, addr + 2, code, i, smnemo, sparm) - addr;
-    break;
-  default :                             /* not a valid instruction ?         */
-    break;
-  }
+PDisassembleOptype pDisassemble = DisassembleOptypes[OpTable[i].ot];
+if (pDisassemble)                       /* disassemble according to op type  */
+  len = (this->*pDisassemble)(addr, addr + 2, code, i, smnemo, sparm) - addr;
 
 // TEST TEST TEST TEST TEST TEST TEST TEST TEST TEST TEST TEST TEST TEST 
 if (showInstTypes)
@@ -1702,147 +1638,76 @@ addr_t Dasm68000::DisassembleEffectiveAddress
     int op_mode
     )
 {
-int mode;
-int reg;
-int32_t displacement;
-int16_t short_adr;
-int index_reg;
-int index_reg_ind;
-int index_size;
-char *s1;
+EffectiveAddress e;
 int32_t a1;
 bool bGetLabel;
-Label *pLbl;
+const char *xreg = NULL, *xsize = NULL;
 
-mode = (ea & 0x38) >> 3;
-reg = ea & 0x7;
-switch(mode)
+addr = DecodeEffectiveAddress(addr, ea, op_mode, e);
+if (e.kind == eaAIndex || e.kind == eaPCIndex)
+  {
+  xreg = e.index_areg ? adr_regs[e.index_reg] : data_regs[e.index_reg];
+  xsize = e.index_areg ? ".L)" : ".W)";
+  }
+switch (e.kind)
   {
-  case 0:
-    s = sformat("%s", data_regs[reg]);
+  case eaDReg:
+    s = data_regs[e.reg];
     break;
-  case 1:
-    s = sformat("%s",adr_regs[reg]);
+  case eaAReg:
+    s = adr_regs[e.reg];
     break;
-  case 2:	/*	address indirect	*/
-    s = sformat("(%s)", adr_regs[reg]);
+  case eaAInd:                          /* address indirect                  */
+    s = string("(") + adr_regs[e.reg] + ")";
     break;
-  case 3:
-    s = sformat("(%s)+", adr_regs[reg]);
+  case eaAPostInc:
+    s = string("(") + adr_regs[e.reg] + ")+";
     break;
-  case 4:
-    s = sformat("-(%s)", adr_regs[reg]);
+  case eaAPreDec:
+    s = string("-(") + adr_regs[e.reg] + ")";
     break;
-  case 5:	/*	address with displacement	*/
-    s = sformat("%s(%s)",
-                Number2String(GetUWord(addr), 4, addr).c_str(),
-                adr_regs[reg]);
-    addr += 2;
+  case eaADisp:                         /* address with displacement         */
+    s = Number2String((uint16_t)e.value, 4, e.ext) + "(" + adr_regs[e.reg] + ")";
     break;
-  case 6:	/*	indexed address with displacement	*/
-    displacement = GetUWord(addr);
-    index_reg = (displacement & 0x7000) >> 12;
-    index_reg_ind = (displacement & 0x8000)>> 15;
-    index_size = (displacement & 0x8000) >> 11;
-    displacement = (signed char)(displacement & 0xff);
-    if (index_size)
-      {
-      s1 = ".L";
-      }
-    else
-      {
-      s1 = ".W";
-      }
-    if (index_reg_ind)
-      {
-      /*	address reg is index reg	*/
-      s = sformat("%s(%s,%s%s)",
-                  Number2String(displacement, 2, addr + 1).c_str(),
-                  adr_regs[reg], adr_regs[index_reg], s1);
-      }
-    else
-      {
-      /*	data reg is index reg	*/
-      s = sformat("%s(%s,%s%s)",
-                  Number2String(displacement, 2, addr + 1).c_str(),
-                  adr_regs[reg], data_regs[index_reg], s1);
-      }
-    addr += 2;
+  case eaAIndex:                        /* indexed address with displacement */
+    s = Number2String(e.value, 2, e.ext + 1) +
+        "(" + adr_regs[e.reg] + "," + xreg + xsize;
     break;
-  case 7:
-    switch (reg)	/*	other modes	*/
-      {
-      case 0:		/*	absolute short	*/
-        short_adr = GetSWord(addr);
-        bGetLabel = !IsConst(addr);
-        pLbl = FindLabel((uint16_t)short_adr);
-        if (pLbl)
-          s = Label2String((uint16_t)short_adr, 4, bGetLabel, addr) + ".S";
-        else
-          s = Number2String(short_adr, 4, addr) + ".S";
-        addr += 2;
-        break;
-      case 1:		/*	absolute long	*/
-        a1 = GetSDWord(addr);
-        bGetLabel = !IsConst(addr);
-        // bIsHex = IsHex(addr);
-        s = Label2String(a1, GetBusWidth() / 4, bGetLabel, addr) + ".L";
-        addr += 4;
-        break;
-      case 2:	/*	program counter with displacement	*/
-        displacement = GetSWord(addr);
-        bGetLabel = !IsConst(addr);
-        a1 = (int32_t)addr + displacement;
-        s = sformat("%s(PC)", Label2String(a1, GetBusWidth() / 4, bGetLabel, addr).c_str());
-        addr += 2;
-        break;
-      case 3:
-        displacement = GetUWord(addr);
-        // bIsHex = IsHex(addr);
-        a1 = (int32_t)addr + (int32_t)(char)(displacement & 0xff);
-        bGetLabel = !IsConst(addr);
-        index_reg = (displacement >> 12) & 0x07;
-        if (displacement & 0x8000)
-          s = sformat("%s(PC,%s%s)",    /* address reg is index reg          */
-                  Label2String(a1, GetBusWidth() / 4, bGetLabel, addr).c_str(),
-                  adr_regs[index_reg],".L");
-        else
-          s = sformat("%s(PC,%s%s)",    /* data reg is index reg             */
-                  Label2String(a1, GetBusWidth() / 4, bGetLabel, addr).c_str(),
-                  data_regs[index_reg],".W");
-        addr += 2;
-        break;
-      case 4:	//Immediate Data
-        /*
-        ** This one is tough
-        */
-        if (op_mode == LONG_SIZE)
-          {
-          bGetLabel = !IsConst(addr);
-          a1 = GetSDWord(addr);
-          s = sformat("#%s.L", Label2String(a1, 8, bGetLabel, addr).c_str());
-          addr += 4;
-          }
-        else if (op_mode == WORD_SIZE || op_mode == BYTE_SIZE)
-          {
-          displacement = GetSWord(addr);
-          if (op_mode == WORD_SIZE)
-            s = sformat("#%s.W",
-                        Number2String(displacement, 4, addr).c_str());
-          else if (op_mode == BYTE_SIZE)
-            {
-            displacement = (char)(displacement & 0xff);
-            s = sformat("#%s.B",Number2String(displacement, 2, addr).c_str());
-            }
-          addr += 2;
-          }
-        break;
-      default :
-        s = sformat("??%d??", reg);
-        break;
-      }	/*	end of switch reg	*/
+  case eaAbsShort:                      /* absolute short                    */
+    bGetLabel = !IsConst(e.ext);
+    if (FindLabel((uint16_t)e.value))
+      s = Label2String((uint16_t)e.value, 4, bGetLabel, e.ext) + ".S";
+    else
+      s = Number2String(e.value, 4, e.ext) + ".S";
+    break;
+  case eaAbsLong:                       /* absolute long                     */
+    bGetLabel = !IsConst(e.ext);
+    s = Label2String(e.value, GetBusWidth() / 4, bGetLabel, e.ext) + ".L";
+    break;
+  case eaPCDisp:                        /* program counter with displacement */
+    bGetLabel = !IsConst(e.ext);
+    a1 = (int32_t)e.ext + e.value;
+    s = Label2String(a1, GetBusWidth() / 4, bGetLabel, e.ext) + "(PC)";
+    break;
+  case eaPCIndex:
+    bGetLabel = !IsConst(e.ext);
+    a1 = (int32_t)e.ext + e.value;
+    s = Label2String(a1, GetBusWidth() / 4, bGetLabel, e.ext) +
+        "(PC," + xreg + xsize;
+    break;
+  case eaImmediate:                     /* immediate data                    */
+    bGetLabel = !IsConst(e.ext);
+    if (op_mode == LONG_SIZE)
+      s = "#" + Label2String(e.value, 8, bGetLabel, e.ext) + ".L";
+    else if (op_mode == WORD_SIZE)
+      s = "#" + Number2String(e.value, 4, e.ext) + ".W";
+    else if (op_mode == BYTE_SIZE)
+      s = "#" + Number2String(e.value, 2, e.ext) + ".B";
+    break;
+  default :
+    s = sformat("??%d??", e.reg);
     break;
-  }	/*	end of switch mode	*/
+  }
 return addr;
 }
 
@@ -50,13 +50,13 @@ class Dasm68000 :
     // return code pointer size in bytes
     virtual int GetCodePtrSize() { return 4; }
     // return highest possible code address
-    virtual caddr_t GetHighestCodeAddr() { return 0xffffff; }
+    virtual codeaddr_t GetHighestCodeAddr() { return 0xffffff; }
     // return data bits
     virtual int GetDataBits() { return 16; }
     // return data pointer size in bytes
     virtual int GetDataPtrSize() { return 4; }
     // return highest possible data address
-    virtual daddr_t GetHighestDataAddr() { return 0xffffff; }
+    virtual dataaddr_t GetHighestDataAddr() { return 0xffffff; }
 
   // Options handler
   protected:
@@ -87,19 +87,22 @@ class Dasm68000 :
     virtual bool DisassembleHexAsc(addr_t addr, addr_t len, addr_t max, string &sHex, string &sAsc, int bus = BusCode)
       {
       // 68000 displays hex in word-sized quantities instead of bytes
-      sAsc = "\'";
-      addr_t i;
-      for (i = 0; i < len; i++)
+      addr_t n = (len > max) ? len : max;
+      string::size_type hpos = sHex.size();
+      sHex.resize(hpos + n * 2 + n / 2, ' '); /* padding is prefilled        */
+      sAsc.assign(n + 2, ' ');
+      sAsc[0] = '\'';
+      sAsc[len + 1] = '\'';
+      char *ph = &sHex[hpos];
+      char *pa = &sAsc[1];
+      const uint8_t *pb = GetSpan(addr, len, bus);
+      for (addr_t i = 0; i < len; i++)
         {
-        uint8_t c = GetUByte(addr + i, bus);
-        sHex += sformat("%02X%s", c, (i & 1) ? " " : "");
-        sAsc += (isprint(c)) ? c : '.'; 
-        }
-      sAsc += '\'';
-      for (; i < max; i++)
-        {
-        sHex += (i & 1) ? "   " : "  ";
-        sAsc += ' ';
+        uint8_t c = pb ? pb[i] : GetUByte(addr + i, bus);
+        ph[0] = hexDigits[c >> 4];
+        ph[1] = hexDigits[c & 0x0f];
+        ph += (i & 1) ? 3 : 2;
+        *pa++ = dumpChars[c];
         }
       return true;
       }
@@ -108,7 +111,7 @@ class Dasm68000 :
     virtual bool String2Number(string s, addr_t &value);
     virtual string Number2String(addr_t value, int nDigits, addr_t addr, int bus = BusCode);
     virtual string Address2String(addr_t addr, int bus = BusCode)
-      { return sformat("$%06x", addr); }
+      { string s("$"); AppendHex(s, addr, 6, false); return s; }
 
   protected:
     enum OpType
@@ -284,13 +287,45 @@ class Dasm68000 :
       };
     static OpDef OpTable[optblSize];
     static OpCode opcodes[mnemo68000_count];
-    uint8_t *otIndex;
+    static uint8_t otIndex[65536];      /* op code -> OpTable index          */
+    static bool bOtIndexBuilt;
+    static bool BuildOtIndex();
+
     bool gas;                           /* flag whether GNU assembler output */
     bool useFCC;
     bool closeCC;
     // TEST TETS TEST TEST TEST TEST TEST TEST TEST TEST TEST TEST TEST
     bool showInstTypes;
 
+    // effective address decoding
+    enum EAKind
+      {
+      eaDReg,                           /* Dn                                */
+      eaAReg,                           /* An                                */
+      eaAInd,                           /* (An)                              */
+      eaAPostInc,                       /* (An)+                             */
+      eaAPreDec,                        /* -(An)                             */
+      eaADisp,                          /* d16(An)                           */
+      eaAIndex,                         /* d8(An,Xn)                         */
+      eaAbsShort,                       /* xxx.S                             */
+      eaAbsLong,                        /* xxx.L                             */
+      eaPCDisp,                         /* d16(PC)                           */
+      eaPCIndex,                        /* d8(PC,Xn)                         */
+      eaImmediate,                      /* #xxx                              */
+      eaInvalid
+      };
+    struct EffectiveAddress
+      {
+      uint8_t kind;                     /* EAKind                            */
+      uint8_t reg;                      /* register number                   */
+      uint8_t index_reg;                /* index register number             */
+      bool index_areg;                  /* index register is An              */
+      addr_t ext;                       /* address of extension word(s)      */
+      int32_t value;                    /* displacement, address or data     */
+      };
+    static uint8_t eaKinds[64];
+    addr_t DecodeEffectiveAddress(addr_t addr, uint16_t ea, int op_mode, EffectiveAddress &e);
+
   protected:
     virtual addr_t ParseEffectiveAddress(addr_t instaddr, addr_t addr, uint16_t ea, int16_t index, int op_mode);
     virtual addr_t ParseOptype01(addr_t instaddr, addr_t addr, uint16_t code, int optable_index);
@@ -352,6 +387,12 @@ class Dasm68000 :
     virtual addr_t DisassembleOptype27(addr_t instaddr, addr_t addr, uint16_t code, int optable_index, string &smnemo, string &sparm);
     virtual addr_t DisassembleOptype28(addr_t instaddr, addr_t addr, uint16_t code, int optable_index, string &smnemo, string &sparm);
     virtual addr_t DisassembleOptype29(addr_t instaddr, addr_t addr, uint16_t code, int optable_index, string &smnemo, string &sparm);
+
+    // op type handler tables, indexed by OpType
+    typedef addr_t (Dasm68000::*PParseOptype)(addr_t instaddr, addr_t addr, uint16_t code, int optable_index);
+    typedef addr_t (Dasm68000::*PDisassembleOptype)(addr_t instaddr, addr_t addr, uint16_t code, int optable_index, string &smnemo, string &sparm);
+    static PParseOptype ParseOptypes[OpType68000_count];
+    static PDisassembleOptype DisassembleOptypes[OpType68000_count];
   };
 
 
@@ -38,14 +38,14 @@ return pDasm;
 }
 
 /*****************************************************************************/
-/* Auto-registration                                                         */
+/* RegisterDasm6801 : register the 6801 disassemblers                        */
 /*****************************************************************************/
 
-static bool bRegistered[] =
-  {
-  RegisterDisassembler("6801", Create6801),
-  RegisterDisassembler("6803", Create6801),
-  };
+bool RegisterDasm6801()
+{
+return RegisterDisassembler("6801", Create6801) &&
+       RegisterDisassembler("6803", Create6801);
+}
 
 
 /*===========================================================================*/
@@ -56,7 +56,7 @@ static bool bRegistered[] =
 /* m6801_codes : table of all 6801 instruction bytes and types               */
 /*****************************************************************************/
 
-uint8_t Dasm6801::m6801_codes[512] =
+Dasm6800::OpDef Dasm6801::m6801_codes[256] =
   {
   _ill  ,_nom,   _nop  ,_imp,   _ill  ,_nom,   _ill  ,_nom,     /* 00..03 */
   _lsrd ,_imp,   _asld ,_imp,   _tap  ,_imp,   _tpa  ,_imp,     /* 04..07 */
@@ -141,16 +141,35 @@ OpCode Dasm6801::opcodes[mnemo6801_count - mnemo6800_count] =
     { "SUBD",  Data },                  /* _subd                             */
   };
 
+/*****************************************************************************/
+/* m6801_descs : 6801 mnemonics and instruction descriptors                  */
+/*****************************************************************************/
+
+OpCode Dasm6801::m6801_mnemo[mnemo6801_count];
+Dasm6800::OpDesc Dasm6801::m6801_descs[256];
+bool Dasm6801::bDescsBuilt = Dasm6801::SetupMnemonics(m6801_mnemo) &&
+                             BuildDescs(m6801_descs, m6801_mnemo, m6801_codes);
+
+/*****************************************************************************/
+/* SetupMnemonics : fill a variant's mnemonics table with the 6801 part      */
+/*****************************************************************************/
+
+bool Dasm6801::SetupMnemonics(OpCode *mnemos)
+{
+Dasm6800::SetupMnemonics(mnemos);
+for (int i = 0; i < mnemo6801_count - mnemo6800_count; i++)
+  mnemos[mnemo6800_count + i] = opcodes[i];
+return true;
+}
+
 /*****************************************************************************/
 /* Dasm6801 : constructor                                                    */
 /*****************************************************************************/
 
 Dasm6801::Dasm6801(void)
 {
-codes = m6801_codes;
-mnemo.resize(mnemo6801_count);          /* set up additional mnemonics       */
-for (int i = 0; i < mnemo6801_count - mnemo6800_count; i++)
-  mnemo[mnemo6800_count + i] = opcodes[i];
+descs = m6801_descs;
+mnemoTbl = m6801_mnemo;
 }
 
 /*****************************************************************************/
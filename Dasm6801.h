@@ -61,8 +61,12 @@ class Dasm6801 : public Dasm6800
       };
 
 
-    static uint8_t m6801_codes[512];
+    static OpDef m6801_codes[256];
     static OpCode opcodes[mnemo6801_count - mnemo6800_count];
+    static OpCode m6801_mnemo[mnemo6801_count];
+    static OpDesc m6801_descs[256];
+    static bool bDescsBuilt;
+    static bool SetupMnemonics(OpCode *mnemos);
   };
 
 #endif // __Dasm6801_h_defined__
@@ -39,10 +39,13 @@ return pDasm;
 }
 
 /*****************************************************************************/
-/* Auto-registration                                                         */
+/* RegisterDasm6809 : register the 6809 disassembler                         */
 /*****************************************************************************/
 
-static bool bRegistered = RegisterDisassembler("6809", Create6809);
+bool RegisterDasm6809()
+{
+return RegisterDisassembler("6809", Create6809);
+}
 
 
 /*****************************************************************************/
@@ -126,7 +129,7 @@ char *Dasm6809::os9_codes[0x100] =
 /* m6809_codes : table of all 6809 instruction bytes and types               */
 /*****************************************************************************/
 
-uint8_t Dasm6809::m6809_codes[512] =
+Dasm6800::OpDef Dasm6809::m6809_codes[256] =
   {
   _neg  ,_dir,   _ill  ,_nom,   _ill  ,_nom,   _com  ,_dir,     /* 00..03 */
   _lsr  ,_dir,   _ill  ,_nom,   _ror  ,_dir,   _asr  ,_dir,     /* 04..07 */
@@ -198,7 +201,7 @@ uint8_t Dasm6809::m6809_codes[512] =
 /* m6809_codes10 : $10 extended instruction 2nd byte                         */
 /*****************************************************************************/
 
-uint8_t Dasm6809::m6809_codes10[512] =
+Dasm6800::OpDef Dasm6809::m6809_codes10[256] =
   {
   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,     /* 00..03 */
   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,     /* 04..07 */
@@ -270,7 +273,7 @@ uint8_t Dasm6809::m6809_codes10[512] =
 /* m6809_codes11 : $11 extended instruction 2nd byte                         */
 /*****************************************************************************/
 
-uint8_t Dasm6809::m6809_codes11[512] =
+Dasm6800::OpDef Dasm6809::m6809_codes11[256] =
   {
   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,     /* 00..03 */
   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,   _ill  ,_nom,     /* 04..07 */
@@ -347,6 +350,13 @@ static char *m6809_exg_tfr[] =
 
 char Dasm6809::reg[] = { 'X', 'Y', 'U', 'S' };
 
+/*****************************************************************************/
+/* m6809_index : indexed addressing post byte descriptions                   */
+/*****************************************************************************/
+
+Dasm6809::IndexDef Dasm6809::m6809_index[256];
+bool Dasm6809::bIndexDefsBuilt = Dasm6809::BuildIndexDefs(m6809_index);
+
 /*****************************************************************************/
 /* opcodes : additional opcodes over 6800                                    */
 /*****************************************************************************/
@@ -418,28 +428,47 @@ OpCode Dasm6809::opcodes[mnemo6809_count - mnemo6800_count] =
 
   };
 
+/*****************************************************************************/
+/* m6809_descs : 6809 mnemonics and instruction descriptors                  */
+/*****************************************************************************/
+
+OpCode Dasm6809::m6809_mnemo[mnemo6809_count];
+Dasm6800::OpDesc Dasm6809::m6809_descs[3 * 256];
+bool Dasm6809::bDescsBuilt = Dasm6809::SetupMnemonics(m6809_mnemo) &&
+                             BuildDescs(m6809_descs, m6809_mnemo,
+                                        m6809_codes, m6809_codes10, m6809_codes11);
+
+/*****************************************************************************/
+/* SetupMnemonics : fill a variant's mnemonics table with the 6809 part      */
+/*****************************************************************************/
+
+bool Dasm6809::SetupMnemonics(OpCode *mnemos)
+{
+Dasm6800::SetupMnemonics(mnemos);
+for (int i = 0; i < mnemo6809_count - mnemo6800_count; i++)
+  mnemos[mnemo6800_count + i] = opcodes[i];
+mnemos[_lda].mne   = "LDA";             /* adjust slight mnemo differences   */
+mnemos[_ldb].mne   = "LDB";
+mnemos[_sta].mne   = "STA";
+mnemos[_stb].mne   = "STB";
+mnemos[_ora].mne   = "ORA";
+mnemos[_orb].mne   = "ORB";
+return true;
+}
+
 /*****************************************************************************/
 /* Dasm6809 : constructor                                                    */
 /*****************************************************************************/
 
 Dasm6809::Dasm6809(void)
 {
-codes = m6809_codes;
-codes10 = m6809_codes10;
-codes11 = m6809_codes11;
+descs = m6809_descs;
+mnemoTbl = m6809_mnemo;
 exg_tfr = m6809_exg_tfr;
+indexDefs = m6809_index;
 os9Patch = false;
 useFlex = false;
 dirpage = 0;
-mnemo.resize(mnemo6809_count);          /* set up additional mnemonics       */
-for (int i = 0; i < mnemo6809_count - mnemo6800_count; i++)
-  mnemo[mnemo6800_count + i] = opcodes[i];
-mnemo[_lda].mne   = "LDA";              /* adjust slight mnemo differences   */
-mnemo[_ldb].mne   = "LDB";
-mnemo[_sta].mne   = "STA";
-mnemo[_stb].mne   = "STB";
-mnemo[_ora].mne   = "ORA";
-mnemo[_orb].mne   = "ORB";
 
 // set up options table
 // class uses one generic option setter/getter pair (not mandatory)
@@ -503,6 +532,24 @@ return
         ;
 }
 
+/*****************************************************************************/
+/* Info file keywords : disassembler-specific info keywords                  */
+/*****************************************************************************/
+
+enum InfoCmd
+  {
+  infoUnknown = -1,                     /* unknown info command              */
+  infoSetDP,                            /* SETDP [addr[-addr]] dp            */
+  infoUnsetDP,                          /* UNSETDP [addr[-addr]]             */
+  };
+static const KeywordTable::Keyword sKey[] =
+  {
+  { "SETDP",        infoSetDP },
+  { "UNSETDP",      infoSetDP },
+  };
+
+static KeywordTable keys(sKey, _countof(sKey));
+
 /*****************************************************************************/
 /* ProcessInfo : process an info file line                                   */
 /*****************************************************************************/
@@ -522,29 +569,7 @@ bool Dasm6809::ProcessInfo
 if (!bProcInfo || bus != BusCode)       /* only if processing code bus...    */
   return false;
 
-enum InfoCmd
-  {
-  infoUnknown = -1,                     /* unknown info command              */
-  infoSetDP,                            /* SETDP [addr[-addr]] dp            */
-  infoUnsetDP,                          /* UNSETDP [addr[-addr]]             */
-  };
-static struct                           /* structure to convert key to type  */
-  {
-  const char *name;
-  InfoCmd cmdType;
-  } sKey[] =
-  {
-  { "SETDP",        infoSetDP },
-  { "UNSETDP",      infoSetDP },
-  };
-
-InfoCmd cmdType = infoUnknown;
-for (int i = 0; i < _countof(sKey); i++)
-  if (key == sKey[i].name)
-    {
-    cmdType = sKey[i].cmdType;
-    break;
-    }
+InfoCmd cmdType = (InfoCmd)keys.Find(key, infoUnknown);
 if (cmdType == infoUnknown)
   return false;
 
@@ -658,35 +683,92 @@ addr_t Dasm6809::FetchInstructionDetails
     )
 {
 O = T = GetUByte(PC++);
-if (T == 0x10)
+const OpDesc *page = descs;
+if (T == 0x10)                          /* select page for prefix byte       */
   {
+  page = descs + 256;
   T = GetUByte(PC++);
-  W = T * 2;
-  MI = T = codes10[W++];
-  I = mnemo[T].mne;
-  M = codes10[W];
   }
 else if (T == 0x11)
   {
+  page = descs + 2 * 256;
   T = GetUByte(PC++);
-  W = T * 2;
-  MI = T = codes11[W++];
-  I = mnemo[T].mne;
-  M = codes11[W];
-  }
-else
-  {
-  W = T * 2;
-  MI = T = codes[W++];
-  M = codes[W];
-  I = mnemo[T].mne;
   }
+const OpDesc &op = page[T];
+MI = T = op.mi;
+M = op.mode;
+I = op.mne;
 
 if (smnemo)
   *smnemo = I;
 return PC;
 }
 
+/*****************************************************************************/
+/* BuildIndexDefs : set up the indexed addressing post byte descriptions     */
+/*****************************************************************************/
+
+// This is done once at program startup; IndexParse() and IndexString()
+// then only need to look at the post byte's description instead of
+// decoding its bits each time.
+
+bool Dasm6809::BuildIndexDefs(IndexDef *defs)
+{
+for (int T = 0; T < 256; T++)
+  {
+  IndexDef &idx = defs[T];
+  char R = reg[(T >> 5) & 0x03];
+  idx.mode = idxFixed;
+  idx.indirect = 0;
+  idx.offset = 0;
+  if (!(T & 0x80))
+    {
+    // lowest 5 bits are a signed offset in range [-16..+15]
+    idx.mode = idxOff5;
+    idx.offset = (int8_t)((T & 0x10) ? ((T & 0x1F) | 0xF0) : (T & 0x1F));
+    sprintf(idx.text, ",%c", R);
+    continue;
+    }
+  switch (T & 0x1F)
+    {
+    case 0x00: sprintf(idx.text, ",%c+", R);     break;
+    case 0x01: sprintf(idx.text, ",%c++", R);    break;
+    case 0x02: sprintf(idx.text, ",-%c", R);     break;
+    case 0x03: sprintf(idx.text, ",--%c", R);    break;
+    case 0x04: sprintf(idx.text, ",%c", R);      idx.mode = idxZero; break;
+    case 0x05: sprintf(idx.text, "B,%c", R);     break;
+    case 0x06: sprintf(idx.text, "A,%c", R);     break;
+    case 0x08: sprintf(idx.text, ",%c", R);      idx.mode = idxOff8; break;
+    case 0x09: sprintf(idx.text, ",%c", R);      idx.mode = idxOff16; break;
+    case 0x0B: sprintf(idx.text, "D,%c", R);     break;
+    case 0x0C: strcpy(idx.text, ",PC");          idx.mode = idxPc8; break;
+    case 0x0D: strcpy(idx.text, ",PCR");         idx.mode = idxPc16; break;
+    case 0x11: sprintf(idx.text, "[,%c++]", R);  break;
+    case 0x13: sprintf(idx.text, "[,--%c]", R);  break;
+    case 0x14: sprintf(idx.text, "[,%c]", R);    break;
+    case 0x15: sprintf(idx.text, "[B,%c]", R);   break;
+    case 0x16: sprintf(idx.text, "[A,%c]", R);   break;
+    case 0x18: sprintf(idx.text, ",%c]", R);     idx.mode = idxInd8; break;
+    case 0x19: sprintf(idx.text, ",%c]", R);     idx.mode = idxAbs16; break;
+    case 0x1B: sprintf(idx.text, "[D,%c]", R);   break;
+    case 0x1C: strcpy(idx.text, ",PC]");         idx.mode = idxInd8; break;
+    case 0x1D: strcpy(idx.text, ",PC]");         idx.mode = idxAbs16; break;
+    default:
+      if (T == 0x9F)
+        {
+        strcpy(idx.text, "]");
+        idx.mode = idxAbs16;
+        }
+      else
+        strcpy(idx.text, "???");
+      break;
+    }
+  if (idx.mode == idxInd8 || idx.mode == idxAbs16)
+    idx.indirect = 1;
+  }
+return true;
+}
+
 /*****************************************************************************/
 /* IndexParse : parses index for labels                                      */
 /*****************************************************************************/
@@ -696,138 +778,102 @@ addr_t Dasm6809::IndexParse(int MI, addr_t pc)
 uint8_t T;
 uint16_t W;
 uint16_t Wrel;
-char R;
 addr_t PC = pc;
 bool bSetLabel = true;
 Label *lbl;
 
 T = GetUByte(PC++);
-R = reg[(T >> 5) & 0x03];
+IndexDef &idx = indexDefs[T];
 
-if (T & 0x80)
+switch (idx.mode)
   {
-  switch(T & 0x1F)
-    {
-    case 0x00:                          /* register operations               */
-    case 0x01:
-    case 0x02:
-    case 0x03:
-    case 0x04:
-    case 0x05:
-    case 0x06:
-    case 0x0B:
-    case 0x11:
-    case 0x13:
-    case 0x14:
-    case 0x15:
-    case 0x16:
-    case 0x1B:
-      break;
-    case 0x0C:
-      bSetLabel = !IsConst(PC);
-      lbl = bSetLabel ? NULL : FindLabel(PC, Const);
-      if (lbl)
-        lbl->SetUsed();
-      T = GetUByte(PC++);
-      if (bSetLabel)
-        AddLabel((uint16_t)((int)((char)T) + PC), mnemo[MI].memType, "", true);
-      break;
-    case 0x08:
-      T = GetUByte(PC);
-      Wrel = (uint16_t)GetRelative(PC);
-      if (Wrel)
-        {
-        W = (uint16_t)((int)((char)T));
-        bSetLabel = !IsConst(PC);
-        lbl = (bSetLabel || Wrel) ? NULL : FindLabel(PC, Const);
-        if (bSetLabel)
-          AddLabel((uint16_t)(W + Wrel), mnemo[MI].memType, "", true);
-        }
-      else
-        lbl = FindLabel(PC, Const);
-      if (lbl)
-        lbl->SetUsed();
-      PC++;
-      break;
-    case 0x18:
-    case 0x1C:
-      lbl = FindLabel(PC, Const);
-      if (lbl)
-        lbl->SetUsed();
-      PC++;
-      break;
-    case 0x0D:
-      bSetLabel = !IsConst(PC);
-      lbl = bSetLabel ? NULL : FindLabel(PC, Const);
-      if (lbl)
-        lbl->SetUsed();
-      SetCellSize(PC, 2);
-      W = GetUWord(PC); PC += 2;
-      if (bSetLabel)
-        AddLabel((uint16_t)(W + PC), mnemo[MI].memType, "", true);
-      break;
-    case 0x09:
+  case idxFixed:                        /* register operations               */
+  case idxZero:
+    break;
+  case idxPc8:
+    bSetLabel = !IsConst(PC);
+    lbl = bSetLabel ? NULL : FindLabel(PC, Const);
+    if (lbl)
+      lbl->SetUsed();
+    T = GetUByte(PC++);
+    if (bSetLabel)
+      AddLabel((uint16_t)((int)((char)T) + PC), mnemoTbl[MI].memType, "", true);
+    break;
+  case idxOff8:
+    T = GetUByte(PC);
+    Wrel = (uint16_t)GetRelative(PC);
+    if (Wrel)
+      {
+      W = (uint16_t)((int)((char)T));
       bSetLabel = !IsConst(PC);
-      Wrel = (uint16_t)GetRelative(PC);
       lbl = (bSetLabel || Wrel) ? NULL : FindLabel(PC, Const);
-      if (lbl)
-        lbl->SetUsed();
-      SetCellSize(PC, 2);
-      W = GetUWord(PC);
-      Wrel += W;
-      PC += 2;
-      // no labels in indirect addressing!
-      // ...except when they are explicitly given in the info file, of course
-      if (W != Wrel ||                  /* if it's relative, or label's there*/
-          FindLabel(Wrel))
-        AddLabel(Wrel,                  /* mark it as used                   */
-                 mnemo[MI].memType, "", true);
-      break;
-    case 0x19:
-    case 0x1D:
-      bSetLabel = !IsConst(PC);
-      lbl = bSetLabel ? NULL : FindLabel(PC, Const);
-      if (lbl)
-        lbl->SetUsed();
-      SetCellSize(PC, 2);
-      W = GetUWord(PC); PC += 2;
       if (bSetLabel)
-        AddLabel(W, mnemo[MI].memType, "", true);
-      break;
-
-    default:
-      if (T == 0x9F)
-        {
-        bSetLabel = !IsConst(PC);
-        lbl = bSetLabel ? NULL : FindLabel(PC, Const);
-        if (lbl)
-          lbl->SetUsed();
-        SetCellSize(PC, 2);
-        W = GetUWord(PC); PC += 2;
-        if (bSetLabel)
-          AddLabel(W, mnemo[MI].memType, "", true);
-        }
-      break;
-    }
-  }
-else
-  {
-  char c = T & 0x1F;
-  if (c & 0x10)
-    c |= 0xf0;
-  Wrel = (uint16_t)GetRelative(PC - 1);
-  if (Wrel)
-    {
-    bSetLabel = !IsConst(PC - 1);
-    lbl = bSetLabel ? NULL : FindLabel(PC - 1, Const);
-    W = (uint16_t)(c + Wrel);
+        AddLabel((uint16_t)(W + Wrel), mnemoTbl[MI].memType, "", true);
+      }
+    else
+      lbl = FindLabel(PC, Const);
+    if (lbl)
+      lbl->SetUsed();
+    PC++;
+    break;
+  case idxInd8:
+    lbl = FindLabel(PC, Const);
+    if (lbl)
+      lbl->SetUsed();
+    PC++;
+    break;
+  case idxPc16:
+    bSetLabel = !IsConst(PC);
+    lbl = bSetLabel ? NULL : FindLabel(PC, Const);
+    if (lbl)
+      lbl->SetUsed();
+    SetCellSize(PC, 2);
+    W = GetUWord(PC); PC += 2;
     if (bSetLabel)
-      AddLabel(W, mnemo[MI].memType, "", true);
-    }
-  else
-    lbl = FindLabel(PC - 1, Const);
-  if (lbl)
-    lbl->SetUsed();
+      AddLabel((uint16_t)(W + PC), mnemoTbl[MI].memType, "", true);
+    break;
+  case idxOff16:
+    bSetLabel = !IsConst(PC);
+    Wrel = (uint16_t)GetRelative(PC);
+    lbl = (bSetLabel || Wrel) ? NULL : FindLabel(PC, Const);
+    if (lbl)
+      lbl->SetUsed();
+    SetCellSize(PC, 2);
+    W = GetUWord(PC);
+    Wrel += W;
+    PC += 2;
+    // no labels in indirect addressing!
+    // ...except when they are explicitly given in the info file, of course
+    if (W != Wrel ||                    /* if it's relative, or label's there*/
+        FindLabel(Wrel))
+      AddLabel(Wrel,                    /* mark it as used                   */
+               mnemoTbl[MI].memType, "", true);
+    break;
+  case idxAbs16:
+    bSetLabel = !IsConst(PC);
+    lbl = bSetLabel ? NULL : FindLabel(PC, Const);
+    if (lbl)
+      lbl->SetUsed();
+    SetCellSize(PC, 2);
+    W = GetUWord(PC); PC += 2;
+    if (bSetLabel)
+      AddLabel(W, mnemoTbl[MI].memType, "", true);
+    break;
+  case idxOff5:
+    Wrel = (uint16_t)GetRelative(PC - 1);
+    if (Wrel)
+      {
+      bSetLabel = !IsConst(PC - 1);
+      lbl = bSetLabel ? NULL : FindLabel(PC - 1, Const);
+      W = (uint16_t)(idx.offset + Wrel);
+      if (bSetLabel)
+        AddLabel(W, mnemoTbl[MI].memType, "", true);
+      }
+    else
+      lbl = FindLabel(PC - 1, Const);
+    if (lbl)
+      lbl->SetUsed();
+    break;
   }
 return PC;
 }
@@ -840,261 +886,117 @@ string Dasm6809::IndexString(addr_t &pc)
 {
 uint8_t T;
 uint16_t W, Wrel;
-char R;
 string buf;
 addr_t PC = pc;
 bool bGetLabel;
 Label *lbl;
 
 T = GetUByte(PC++);
-R = reg[(T >> 5) & 0x03];
+IndexDef &idx = indexDefs[T];
 
-if (T & 0x80)
+switch (idx.mode)
   {
-  switch (T & 0x1F)
-    {
-    case 0x00:
-      buf = sformat(",%c+", R);
-      break;
-    case 0x01:
-      buf = sformat(",%c++", R);
-      break;
-    case 0x02:
-      buf = sformat(",-%c", R);
-      break;
-    case 0x03:
-      buf = sformat(",--%c", R);
-      break;
-    case 0x04:
-      buf = sformat(",%c", R);
-      if (GetRelative(PC - 1))
-        {
-        bGetLabel = !IsConst(PC - 1);
-        buf += sformat("   %s (%s)",
-                       commentStart.c_str(),
-                       Label2String(0, 4, bGetLabel, PC - 1).c_str());
-        }
-      break;
-    case 0x05:
-      buf = sformat("B,%c", R);
-      break;
-    case 0x06:
-      buf = sformat("A,%c", R);
-      break;
-    case 0x08:
-      bGetLabel = !IsConst(PC);
-#if 1
-      // looks better...
-      T = GetUByte(PC);
-      W = T + (uint16_t)GetDirectPage(PC);
-      Wrel = W + (uint16_t)GetRelative(PC);
-      lbl = (bGetLabel || Wrel != W) ? NULL : FindLabel(PC, Const);
-      if (bGetLabel && (Wrel != W || FindLabel(Wrel)))
-        {
-        string slbl = lbl ? lbl->GetText() : Label2String(W, 4, bGetLabel, PC);
-        buf = sformat("<%s,%c", slbl.c_str(), R);
-        }
-      else
-        {
-        string slbl = lbl ? lbl->GetText() : Number2String(T, 2, PC);
-        buf = sformat("<%s,%c", slbl.c_str(), R);
-        }
-      PC++;
-#else
-      T = GetUByte(PC);
-      Wrel = (uint16_t)GetRelative(PC);
-      lbl = (bGetLabel || Wrel) ? NULL : FindLabel(PC, Const);
-      PC++;
-      /*
-      Something's definitely not right here. This needs a bit of redesign.
-      0x08 should be like 0x09, just with Direct addressing, and forward
-      references should be qualified with "<" to assure they're not treated
-      as Extended by the Assembler.
-      */
-      if (Wrel)
-        {
-        W = (int)((char)T) + Wrel;
-        string slbl = lbl ? lbl->GetText() : Label2String((uint16_t)((int)((char)T)), 4, bGetLabel, PC - 1);
-                                        /* "<" needed for forward declaration*/
-        buf = sformat(
-                ((W > PC) || (Wrel > PC)) ? "<%s,%c" : "%s,%c",
-                slbl.c_str(),
-                R);
-        }
-      else
-        {
-        string slbl = lbl ? lbl->GetText() : SignedNumber2String((int)((char)T), 2, PC - 1);
-        buf = sformat("%s,%c", slbl.c_str(), R);
-        }
-#endif
-      break;
-    case 0x09:
-      bGetLabel = !IsConst(PC);
-      W = GetUWord(PC);
-      Wrel = W + (uint16_t)GetRelative(PC);
-      lbl = (bGetLabel || Wrel) ? NULL : FindLabel(PC, Const);
-      if ((Wrel != W) || FindLabel(Wrel))
-        {
-        string slbl = lbl ? lbl->GetText() : Label2String(W, 4, bGetLabel, PC);
-        if (((W < 0x80) || (W >= 0xff80)) && forceExtendedAddr)
-          buf = sformat(">%s,%c", slbl.c_str(), R);
-        else
-          buf = sformat("%s,%c", slbl.c_str(), R);
-        }
-      else
-        {
-        string slbl;
-        if (((W < 0x80) || (W >= 0xff80)) && forceExtendedAddr)
-          {
-          slbl = lbl ? lbl->GetText() : SignedNumber2String((int)(short)W, 4, PC);
-          buf = sformat(">%s,%c", slbl.c_str(), R);
-          }
-        else
-          {
-          slbl = lbl ? lbl->GetText() : Number2String((uint16_t)(int)(short)W, 4, PC);  /* RB: this was "signed_string" */
-          buf = sformat("%s,%c", slbl.c_str(), R);
-          }
-        }
-      PC += 2;
-      break;
-    case 0x0B:
-      buf = sformat("D,%c", R);
-      break;
-    case 0x0C:
-      T = GetUByte(PC);
-      bGetLabel = !IsConst(PC);
-#if 0
-      sprintf(buf,"$%s,PC",signed_string((int)(char)T, 2, (word)PC));
-#else
-      if (bGetLabel)
-        buf = Label2String((uint16_t)((int)((char)T) + PC + 1), 4,
-                           bGetLabel, PC) + ",PCR";
-      else
-        {
-        lbl = FindLabel(PC, Const);
-        string slbl = lbl ? lbl->GetText() : Number2String((uint16_t)(int)(char)T, 2, PC);
-        buf = slbl + ",PC";
-        }
-#endif
-      PC++;
-      break;
-    case 0x0D:
-      {
-      bGetLabel = !IsConst(PC);
-      lbl = bGetLabel ? NULL : FindLabel(PC, Const);
-      W = GetUWord(PC);
-      PC += 2;
-      string slbl = lbl ? lbl->GetText() :
-                          Label2String((uint16_t)(W + PC), 4, bGetLabel, PC - 2);
-      if (((W < 0x80) || (W >= 0xff80)) && forceExtendedAddr)
-        buf = sformat(">%s,PCR", slbl.c_str());
-      else
-        buf = sformat("%s,PCR", slbl.c_str());
-      }
-      break;
-    case 0x11:
-      buf = sformat("[,%c++]", R);
-      break;
-    case 0x13:
-      buf = sformat("[,--%c]", R);
-      break;
-    case 0x14:
-      buf = sformat("[,%c]", R);
-      break;
-    case 0x15:
-      buf = sformat("[B,%c]", R);
-      break;
-    case 0x16:
-      buf = sformat("[A,%c]", R);
-      break;
-    case 0x18:
-      {
-      lbl = FindLabel(PC, Const);
-      T = GetUByte(PC);
-      string slbl = lbl ? lbl->GetText() : Number2String(T, 2, PC);
-      buf = sformat("[%s,%c]",
-              slbl.c_str(),
-              R);
-      PC++;
-      }
-      break;
-    case 0x19:
+  case idxFixed:
+    buf = idx.text;
+    break;
+  case idxZero:
+    buf = idx.text;
+    if (GetRelative(PC - 1))
       {
-      bGetLabel = !IsConst(PC);
-      lbl = bGetLabel ? NULL : FindLabel(PC, Const);
-      W = GetUWord(PC);
-      string slbl = lbl ? lbl->GetText() : Label2String(W, 4, bGetLabel, PC);
-      buf = sformat("[%s,%c]", slbl.c_str(), R);
-      PC += 2;
+      bGetLabel = !IsConst(PC - 1);
+      buf += "   " + commentStart + " (" +
+             Label2String(0, 4, bGetLabel, PC - 1) + ")";
       }
-      break;
-    case 0x1B:
-      buf = sformat("[D,%c]", R);
-      break;
-    case 0x1C:
+    break;
+  case idxOff8:
+    bGetLabel = !IsConst(PC);
+    T = GetUByte(PC);
+    W = T + (uint16_t)GetDirectPage(PC);
+    Wrel = W + (uint16_t)GetRelative(PC);
+    lbl = (bGetLabel || Wrel != W) ? NULL : FindLabel(PC, Const);
+    buf = "<";
+    if (lbl)
+      buf += lbl->GetText();
+    else if (bGetLabel && (Wrel != W || FindLabel(Wrel)))
+      buf += Label2String(W, 4, bGetLabel, PC);
+    else
+      buf += Number2String(T, 2, PC);
+    buf += idx.text;
+    PC++;
+    break;
+  case idxOff16:
+    bGetLabel = !IsConst(PC);
+    W = GetUWord(PC);
+    Wrel = W + (uint16_t)GetRelative(PC);
+    lbl = (bGetLabel || Wrel) ? NULL : FindLabel(PC, Const);
+    if (((W < 0x80) || (W >= 0xff80)) && forceExtendedAddr)
+      buf = ">";
+    if (lbl)
+      buf += lbl->GetText();
+    else if ((Wrel != W) || FindLabel(Wrel))
+      buf += Label2String(W, 4, bGetLabel, PC);
+    else if (((W < 0x80) || (W >= 0xff80)) && forceExtendedAddr)
+      buf += SignedNumber2String((int)(short)W, 4, PC);
+    else                                /* RB: this was "signed_string"      */
+      buf += Number2String((uint16_t)(int)(short)W, 4, PC);
+    buf += idx.text;
+    PC += 2;
+    break;
+  case idxPc8:
+    T = GetUByte(PC);
+    bGetLabel = !IsConst(PC);
+    if (bGetLabel)
+      buf = Label2String((uint16_t)((int)((char)T) + PC + 1), 4,
+                         bGetLabel, PC) + ",PCR";
+    else
       {
       lbl = FindLabel(PC, Const);
-      T = GetUByte(PC);
-      string slbl = lbl ? lbl->GetText() : Number2String(T, 2, PC);
-      buf = sformat("[%s,PC]", slbl.c_str());
-      PC++;
-      }
-      break;
-    case 0x1D:
-      {
-      bGetLabel = !IsConst(PC);
-      lbl = bGetLabel ? NULL : FindLabel(PC, Const);
-      W = GetUWord(PC);
-      string slbl = lbl ? lbl->GetText() : Label2String(W, 4, bGetLabel, PC);
-      buf = sformat("[%s,PC]", slbl.c_str());
-      PC += 2;
+      buf = lbl ? lbl->GetText() : Number2String((uint16_t)(int)(char)T, 2, PC);
+      buf += idx.text;
       }
-      break;
-    case 0x07:
-    case 0x17:
-    case 0x0A:
-    case 0x1A:
-    case 0x0E:
-    case 0x1E:
-      buf = "???";
-      break;
-             
-    default:
-      if (T == 0x9F)
-        {
-        bGetLabel = !IsConst(PC);
-        lbl = bGetLabel ? NULL : FindLabel(PC, Const);
-        W = GetUWord(PC);
-        string slbl = lbl ? lbl->GetText() : Label2String(W, 4, bGetLabel, PC);
-        buf = sformat("[%s]", slbl.c_str());
-        PC += 2;
-        }
-      else
-        buf = "???";
-      break;
-    }
-    
-  }
-else
-  {
-  // lowest 5 bits are a signed offset in range [-16..+15]
-  char c = T & 0x1F;
-  if (c & 0x10)
-    c |= 0xf0;
-  bGetLabel = !IsConst(PC - 1);
-  Wrel = (uint16_t)GetRelative(PC - 1);
-  if (Wrel)
-    {
-    lbl = bGetLabel ? NULL : FindLabel(PC - 1, Const);
-    string slbl = lbl ? lbl->GetText() : Label2String((uint16_t)c, 4, bGetLabel, PC - 1);
-    buf = sformat("%s,%c", slbl.c_str(), R);
-    }
-  else
-    {
-    lbl = FindLabel(PC - 1, Const);
-    string slbl = lbl ? lbl->GetText() : SignedNumber2String(c, 2, PC - 1);
-    buf = sformat("%s,%c", slbl.c_str(), R);
-    }
+    PC++;
+    break;
+  case idxPc16:
+    bGetLabel = !IsConst(PC);
+    lbl = bGetLabel ? NULL : FindLabel(PC, Const);
+    W = GetUWord(PC);
+    PC += 2;
+    if (((W < 0x80) || (W >= 0xff80)) && forceExtendedAddr)
+      buf = ">";
+    buf += lbl ? lbl->GetText() :
+                 Label2String((uint16_t)(W + PC), 4, bGetLabel, PC - 2);
+    buf += idx.text;
+    break;
+  case idxInd8:
+    lbl = FindLabel(PC, Const);
+    T = GetUByte(PC);
+    buf = "[";
+    buf += lbl ? lbl->GetText() : Number2String(T, 2, PC);
+    buf += idx.text;
+    PC++;
+    break;
+  case idxAbs16:
+    bGetLabel = !IsConst(PC);
+    lbl = bGetLabel ? NULL : FindLabel(PC, Const);
+    W = GetUWord(PC);
+    if (idx.indirect)
+      buf = "[";
+    buf += lbl ? lbl->GetText() : Label2String(W, 4, bGetLabel, PC);
+    buf += idx.text;
+    PC += 2;
+    break;
+  case idxOff5:
+    bGetLabel = !IsConst(PC - 1);
+    Wrel = (uint16_t)GetRelative(PC - 1);
+    lbl = (Wrel && bGetLabel) ? NULL : FindLabel(PC - 1, Const);
+    if (lbl)
+      buf = lbl->GetText();
+    else if (Wrel)
+      buf = Label2String((uint16_t)idx.offset, 4, bGetLabel, PC - 1);
+    else
+      buf = SignedNumber2String(idx.offset, 2, PC - 1);
+    buf += idx.text;
+    break;
   }
 
 pc = PC;
@@ -1138,7 +1040,7 @@ switch (M)                              /* which mode is this ?              */
         {
         W = (uint16_t)dp | T;
         W = (uint16_t)PhaseInner(W, PC);
-        AddLabel(W, mnemo[MI].memType, "", true);
+        AddLabel(W, mnemoTbl[MI].memType, "", true);
         }
       }
     PC++;
@@ -1158,7 +1060,7 @@ switch (M)                              /* which mode is this ?              */
     W += (uint16_t)PC;
     W = (uint16_t)DephaseOuter(W, PC - 2);
     if (bSetLabel)
-      AddLabel(W, mnemo[MI].memType, "", true);
+      AddLabel(W, mnemoTbl[MI].memType, "", true);
     break;
     
   case _r1:                             /* tfr/exg mode                      */
@@ -1217,43 +1119,43 @@ switch (M)                              /* which mode is this?               */
     switch (W)                          /* examine for special CC settings   */
       {
       case 0x1a01 :                     /* (6809) ORCC $01                   */
-        smnemo = mnemo[_sec].mne;
+        smnemo = mnemoTbl[_sec].mne;
         break;
       case 0x1a02 :                     /* (6809) ORCC $02                   */
-        smnemo = mnemo[_sev].mne;
+        smnemo = mnemoTbl[_sev].mne;
         break;
       case 0x1a04 :                     /* (6809) ORCC $04                   */
-        smnemo = mnemo[_sez].mne;
+        smnemo = mnemoTbl[_sez].mne;
         break;
       case 0x1a10 :                     /* (6809) ORCC $10                   */
-        smnemo = mnemo[_sei].mne;
+        smnemo = mnemoTbl[_sei].mne;
         break;
       case 0x1a40 :                     /* (6809) ORCC $40                   */
-        smnemo = mnemo[_sef].mne;
+        smnemo = mnemoTbl[_sef].mne;
         break;
       case 0x1a50 :                     /* (6809) ORCC $40+$10               */
-        smnemo = mnemo[_seif].mne;
+        smnemo = mnemoTbl[_seif].mne;
         break;
       case 0x1cfe :                     /* (6809) ANDCC ~$01                 */
-        smnemo = mnemo[_clc].mne;
+        smnemo = mnemoTbl[_clc].mne;
         break;
       case 0x1cfd :                     /* (6809) ANDCC ~$02                 */
-        smnemo =  mnemo[_clv].mne;
+        smnemo =  mnemoTbl[_clv].mne;
         break;
       case 0x1cfb :                     /* (6809) ANDCC ~$04                 */
-        smnemo = mnemo[_clz].mne;
+        smnemo = mnemoTbl[_clz].mne;
         break;
       case 0x1cef :                     /* (6809) ANDCC ~$10                 */
-        smnemo = mnemo[_cli].mne;
+        smnemo = mnemoTbl[_cli].mne;
         break;
       case 0x1cbf :                     /* (6809) ANDCC ~$40                 */
-        smnemo = mnemo[_clf].mne;
+        smnemo = mnemoTbl[_clf].mne;
         break;
       case 0x1caf :                     /* (6809) ANDCC ~($40 + $10)         */
-        smnemo = mnemo[_clif].mne;
+        smnemo = mnemoTbl[_clif].mne;
         break;
       case 0x3cff :                     /* (6809) CWAI $FF                   */
-        smnemo = mnemo[_wai].mne;
+        smnemo = mnemoTbl[_wai].mne;
         break;
       default :
         lbl = FindLabel(PC, Const, bus);
@@ -1303,28 +1205,28 @@ switch (M)                              /* which mode is this?               */
     switch (W)
       {
       case 0x3001 :                     /* (6809) LEAX +1                    */
-        smnemo = mnemo[_inx].mne; PC++;
+        smnemo = mnemoTbl[_inx].mne; PC++;
         break;
       case 0x301f :                     /* (6809) LEAX -1                    */
-        smnemo = mnemo[_dex].mne; PC++;
+        smnemo = mnemoTbl[_dex].mne; PC++;
         break;
       case 0x3121 :                     /* (6809) LEAY +1                    */
-        smnemo = mnemo[_iny].mne; PC++;
+        smnemo = mnemoTbl[_iny].mne; PC++;
         break;
       case 0x313f :                     /* (6809) LEAY -1                    */
-        smnemo = mnemo[_dey].mne; PC++;
+        smnemo = mnemoTbl[_dey].mne; PC++;
         break;
       case 0x3261 :                     /* (6809) LEAS +1                    */
-        smnemo = mnemo[_ins].mne; PC++;
+        smnemo = mnemoTbl[_ins].mne; PC++;
         break;
       case 0x327f :                     /* (6809) LEAS -1                    */
-        smnemo = mnemo[_des].mne; PC++;
+        smnemo = mnemoTbl[_des].mne; PC++;
         break;
       case 0x3341 :                     /* (6809) LEAU +1                    */
-        smnemo = mnemo[_inu].mne; PC++;
+        smnemo = mnemoTbl[_inu].mne; PC++;
         break;
       case 0x335f :                     /* (6809) LEAU -1                    */
-        smnemo = mnemo[_deu].mne; PC++;
+        smnemo = mnemoTbl[_deu].mne; PC++;
         break;
       default :
         sparm = IndexString(PC);
@@ -1350,10 +1252,10 @@ switch (M)                              /* which mode is this?               */
     switch (W)
       {
       case 0x1f14 :                     /* (6809) TFR X,S                    */
-        smnemo = mnemo[_txs].mne; PC++;
+        smnemo = mnemoTbl[_txs].mne; PC++;
         break;
       case 0x1f41 :                     /* (6809) TFR S,X                    */
-        smnemo = mnemo[_tsx].mne; PC++;
+        smnemo = mnemoTbl[_tsx].mne; PC++;
         break;
 /* hairy - some assemblers expand TAB to TAB + TSTA...
    but there's no guarantee.
@@ -1361,7 +1263,7 @@ switch (M)                              /* which mode is this?               */
         smnemo = "TAB"; PC++;
         break; */
       case 0x1f8a :                     /* (6809) TFR A,CC                   */
-        smnemo = mnemo[_tap].mne; PC++;
+        smnemo = mnemoTbl[_tap].mne; PC++;
         break;
 /* hairy - some assemblers expand TBA to TBA + TSTA...
    but there's no guarantee.
@@ -1369,7 +1271,7 @@ switch (M)                              /* which mode is this?               */
         smnemo = "TBA"; PC++;
         break; */
       case 0x1fa8 :                     /* (6809) TFR CC,A                   */
-        smnemo = mnemo[_tpa].mne; PC++;
+        smnemo = mnemoTbl[_tpa].mne; PC++;
         break;
       default :
         T = GetUByte(PC++);
@@ -1394,21 +1296,21 @@ switch (M)                              /* which mode is this?               */
         switch (W)
           {
           case 0xa0e0 :                 /* (6809) PSHS B / SUBA ,S++         */
-            smnemo = mnemo[_sba].mne; PC += 3;
+            smnemo = mnemoTbl[_sba].mne; PC += 3;
             break;
           case 0xa1e0 :                 /* (6809) PSHS B / CMPA ,S++         */
-            smnemo = mnemo[_cba].mne; PC += 3;
+            smnemo = mnemoTbl[_cba].mne; PC += 3;
             break;
           case 0xabe0 :                 /* (6809) PSHS B / ADDA ,S++         */
-            smnemo = mnemo[_aba].mne; PC += 3;
+            smnemo = mnemoTbl[_aba].mne; PC += 3;
             break;
           default:                      /* (6809) PSHS B / anything else     */
-            smnemo = mnemo[_pshb].mne; PC++;
+            smnemo = mnemoTbl[_pshb].mne; PC++;
             break;
           }
         break;
       case 0x3402 :                     /* (6809) PSHS A                     */
-        smnemo = mnemo[_psha].mne; PC++;
+        smnemo = mnemoTbl[_psha].mne; PC++;
         break;
       case 0x3406 :                     /* (6809) PSHS D                     */
         smnemo = "PSHD"; PC++;
@@ -1420,10 +1322,10 @@ switch (M)                              /* which mode is this?               */
         smnemo = "PSHY"; PC++;
         break;
       case 0x3502 :                     /* (6809) PULS A                     */
-        smnemo = mnemo[_pula].mne; PC++;
+        smnemo = mnemoTbl[_pula].mne; PC++;
         break;
       case 0x3504 :                     /* (6809) PULS B                     */
-        smnemo = mnemo[_pulb].mne; PC++;
+        smnemo = mnemoTbl[_pulb].mne; PC++;
         break;
       case 0x3506 :                     /* (6809) PULS D                     */
         smnemo = "PULD"; PC++;
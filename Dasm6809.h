@@ -229,18 +229,45 @@ class Dasm6809 : public Dasm6800
       mnemo6809_count
       };
 
-    static uint8_t m6809_codes[512];
-    static uint8_t m6809_codes10[512];
-    static uint8_t m6809_codes11[512];
+    static OpDef m6809_codes[256];
+    static OpDef m6809_codes10[256];
+    static OpDef m6809_codes11[256];
     static OpCode opcodes[mnemo6809_count - mnemo6800_count];
+    static OpCode m6809_mnemo[mnemo6809_count];
+    static OpDesc m6809_descs[3 * 256];
+    static bool bDescsBuilt;
+    static bool SetupMnemonics(OpCode *mnemos);
     static char *os9_codes[0x100];
     addr_t dirpage;
 
-    uint8_t *codes10;
-    uint8_t *codes11;
     char **exg_tfr;
     static char reg[];
 
+    // indexed addressing post byte decoding
+    enum IndexMode
+      {
+      idxFixed,                         /* no offset; text is complete       */
+      idxZero,                          /* ,R (may carry a relative comment) */
+      idxOff5,                          /* 5-bit offset in post byte         */
+      idxOff8,                          /* 8-bit offset,R                    */
+      idxOff16,                         /* 16-bit offset,R                   */
+      idxPc8,                           /* 8-bit offset,PCR                  */
+      idxPc16,                          /* 16-bit offset,PCR                 */
+      idxInd8,                          /* [8-bit offset,R|PC]               */
+      idxAbs16,                         /* 16-bit address or offset          */
+      };
+    struct IndexDef
+      {
+      uint8_t mode;                     /* IndexMode                         */
+      uint8_t indirect;                 /* text is preceded by "["           */
+      int8_t offset;                    /* 5-bit offset for idxOff5          */
+      char text[7];                     /* text, or text after the offset    */
+      };
+    static IndexDef m6809_index[256];
+    static bool bIndexDefsBuilt;
+    static bool BuildIndexDefs(IndexDef *defs);
+    IndexDef *indexDefs;
+
     bool os9Patch;
     bool useFlex;
 
@@ -39,13 +39,13 @@ return pDasm;
 }
 
 /*****************************************************************************/
-/* Auto-registration                                                         */
+/* RegisterDasmAvr8 : register the avr8 disassembler                         */
 /*****************************************************************************/
 
-static bool bRegistered[] =
-  {
-  RegisterDisassembler("avr8", CreateAvr8),
-  };
+bool RegisterDasmAvr8()
+{
+return RegisterDisassembler("avr8", CreateAvr8);
+}
 
 
 /*===========================================================================*/
@@ -348,6 +348,20 @@ avrInstructionInfo DasmAvr8::AVR_Instruction_Set[] =
     { _subi,   2, 0x5000, 2, {0x00f0, 0x0f0f}, {OpndRegStartR16, OpndData}},
   };
 
+/*****************************************************************************/
+/* instIndex : opcode to AVR_Instruction_Set index translation               */
+/*****************************************************************************/
+
+uint8_t DasmAvr8::instIndex[65536];
+bool DasmAvr8::bInstIndexBuilt = DasmAvr8::BuildInstructionIndex();
+
+/*****************************************************************************/
+/* byteStrings : prerendered byte values                                     */
+/*****************************************************************************/
+
+char DasmAvr8::byteStrings[byteFormats_count][256][12];
+bool DasmAvr8::bByteStringsBuilt = DasmAvr8::BuildByteStrings();
+
 /*****************************************************************************/
 /* DasmAvr8 : constructor                                                    */
 /*****************************************************************************/
@@ -449,24 +463,9 @@ return sformat("REGLABEL addr Reg [text]\n"
 }
 
 /*****************************************************************************/
-/* ProcessInfo : process an info file line                                   */
+/* Info file keywords : disassembler-specific info keywords                  */
 /*****************************************************************************/
 
-bool DasmAvr8::ProcessInfo
-    (
-    string key,                         /* parsed key                        */
-    string value,                       /* rest of the line                  */
-    addr_t &from,                       /* from/to (if range given)          */
-    addr_t &to, 
-    vector<TMemoryArray<addr_t>> &remaps,  /* remaps, if necessary           */
-    bool bProcInfo,                     /* flag whether processing           */
-    int bus,                            /* target bus for command            */
-    int tgtbus                          /* target bus for parameters         */
-    )
-{
-if (!bProcInfo)                         /* only if processing                */
-  return false;
-
 enum InfoCmd
   {
   infoUnknown = -1,                     /* unknown info command              */
@@ -479,11 +478,7 @@ enum InfoCmd
   infoHigh2,                            /* HIGH2 [BUS bus] addr[-addr] addr/2*/
   infoLow2,                             /* LOW2 [BUS bus] addr[-addr] addr/2 */
   };
-static struct                           /* structure to convert key to type  */
-  {
-  const char *name;
-  InfoCmd cmdType;
-  } sKey[] =
+static const KeywordTable::Keyword sKey[] =
   {
   { "REGLABEL",     infoRegLabel },
   { "UNREGLABEL",   infoUnregLabel },
@@ -495,13 +490,28 @@ static struct                           /* structure to convert key to type  */
   { "LOW2",         infoLow2 },
   };
 
-InfoCmd cmdType = infoUnknown;
-for (int i = 0; i < _countof(sKey); i++)
-  if (key == sKey[i].name)
-    {
-    cmdType = sKey[i].cmdType;
-    break;
-    }
+static KeywordTable keys(sKey, _countof(sKey));
+
+/*****************************************************************************/
+/* ProcessInfo : process an info file line                                   */
+/*****************************************************************************/
+
+bool DasmAvr8::ProcessInfo
+    (
+    string key,                         /* parsed key                        */
+    string value,                       /* rest of the line                  */
+    addr_t &from,                       /* from/to (if range given)          */
+    addr_t &to, 
+    vector<TMemoryArray<addr_t>> &remaps,  /* remaps, if necessary           */
+    bool bProcInfo,                     /* flag whether processing           */
+    int bus,                            /* target bus for command            */
+    int tgtbus                          /* target bus for parameters         */
+    )
+{
+if (!bProcInfo)                         /* only if processing                */
+  return false;
+
+InfoCmd cmdType = (InfoCmd)keys.Find(key, infoUnknown);
 if (cmdType == infoUnknown)
   return false;
 
@@ -929,26 +939,55 @@ if (rt != MemAttributeAvr8::RelUntyped)
     }
   }
 
+if ((nDigits == 2) && (value <= 0xff))  /* if byte value, use prerendered    */
+  {
+  ByteFormat fmt;
+  switch (disp)
+    {
+    case MemAttribute::Char :
+      fmt = bfChar;
+      break;
+    case MemAttribute::Binary :
+      fmt = bfBinary;
+      break;
+    case MemAttribute::Hex :
+      fmt = bfHex;
+      break;
+    default :
+      fmt = bSigned ? bfSigned : bfDecimal;
+      break;
+    }
+  return byteStrings[fmt][value];
+  }
+
 if ((nDigits == 2) &&                   /* if 2-digit value                  */
     (disp == MemAttribute::Char))       /* and character output requested    */
   {
   if (isprint(value))
-    s = sformat("'%c'", value);
+    {
+    s = '\'';
+    s += (char)value;
+    s += '\'';
+    }
   else
-    s = sformat("0x%02x", value);
+    AppendHex(s = "0x", value, 2, false);
   }
 else if (disp == MemAttribute::Binary)  /* if a binary                       */
   {
-  int nBit;
-
   nDigits *= 4;                         /* convert from digits to bits       */
   s = "0b";                             /* prepare a binary value            */
-                                        /* now do for all bits               */
-  for (nBit = nDigits - 1; nBit >= 0; nBit--) 
-    s.push_back('0' + (!!(value & (1 << nBit))));
+  AppendBin(s, value, nDigits);         /* now do for all bits               */
+  }
+else if ((disp == MemAttribute::Hex) &&  /* if hex in whole bytes             */
+         !(nDigits & 1) && nDigits <= 8 &&
+         (nDigits == 8 || !(value >> (nDigits * 4))))
+  {
+  s = "0x";                             /* compose from prerendered bytes    */
+  for (int i = nDigits / 2 - 1; i >= 0; i--)
+    s += byteStrings[bfHex][(value >> (i * 8)) & 0xff] + 2;
   }
 else if (disp == MemAttribute::Hex)     /* if hex                            */
-  s = sformat("0x%0*x", nDigits, value);/* prepare a hex value               */
+  AppendHex(s = "0x", value, nDigits, false); /* prepare a hex value        */
 #if 0
 else if (disp == MemAttribute::Octal)   /* if octal display                  */
   s = sformat("@%0*o", (nDigits * 4) + 2 / 3, value);
@@ -961,14 +1000,41 @@ else                                    /* otherwise                         */
     if (nDigits == 2) sval = (int32_t)((int8_t)value);
     else if (nDigits == 4) sval = (int32_t)((int16_t)value);
     else sval = (int32_t)value;
-    s = sformat("%d", sval);            /* prepare signed decimal value      */
+    AppendSigned(s, sval);              /* prepare signed decimal value      */
     }
   else
-    s = sformat("%u", value);           /* prepare unsigned decimal value    */
+    AppendDec(s, value);                /* prepare unsigned decimal value    */
   }
 return s;                               /* pass back generated string        */
 }
 
+/*****************************************************************************/
+/* BuildByteStrings : prerender all byte values in all display formats       */
+/*****************************************************************************/
+
+bool DasmAvr8::BuildByteStrings()
+{
+for (int i = 0; i < 256; i++)
+  {
+  string s[byteFormats_count];
+  if (isprint(i))
+    {
+    s[bfChar] = '\'';
+    s[bfChar] += (char)i;
+    s[bfChar] += '\'';
+    }
+  else
+    AppendHex(s[bfChar] = "0x", i, 2, false);
+  AppendBin(s[bfBinary] = "0b", i, 8);
+  AppendHex(s[bfHex] = "0x", i, 2, false);
+  AppendDec(s[bfDecimal], i);
+  AppendSigned(s[bfSigned], (int8_t)i);
+  for (int fmt = 0; fmt < byteFormats_count; fmt++)
+    strcpy(byteStrings[fmt][i], s[fmt].c_str());
+  }
+return true;
+}
+
 /*****************************************************************************/
 /* InitParse : initialize parsing                                            */
 /*****************************************************************************/
@@ -1206,7 +1272,7 @@ if (ii == NULL)
 int numOperands = ii->numOperands;
 for (i = 0; i < numOperands; i++)
   {
-  uint32_t o = GetMaskBits(opcode, ii->operandMasks[i]);
+  uint32_t o = GetOperandBits(opcode, ii, i);
   /* Append the extra bits if it's a long operand */
   if (ii->operandTypes[i] == OpndLongAbsAddr ||
       ii->operandTypes[i] == OpndLongAbsAddrData)
@@ -1336,7 +1402,7 @@ if (ii == NULL)                         /* if no instruction,                */
 int numOperands = ii->numOperands;
 for (i = 0; i < numOperands; i++)
   {
-  uint32_t o = GetMaskBits(opcode, ii->operandMasks[i]);
+  uint32_t o = GetOperandBits(opcode, ii, i);
   // Append the extra bits if it's a long operand
   if (ii->operandTypes[i] == OpndLongAbsAddr ||
       ii->operandTypes[i] == OpndLongAbsAddrData)
@@ -1647,25 +1713,49 @@ return Disassembler::DisassembleChanges(addr, prevaddr, prevsz, bAfterLine, chan
 }
 
 /*****************************************************************************/
-/* LookupInstruction : look up the instruction definition for an opcode      */
+/* BuildInstructionIndex : set up the opcode lookup tables                   */
 /*****************************************************************************/
 
-avrInstructionInfo *DasmAvr8::LookupInstruction(uint16_t opcode)
+// This is done once at program startup for all DasmAvr8 instances.
+// The first matching entry in AVR_Instruction_Set wins, so the table is
+// filled from the end; each entry only visits the opcodes it can match
+// by enumerating all values of its operand bits. Operand masks are split
+// into contiguous fields so that GetOperandBits() can extract an operand
+// with a few shifts instead of testing it bit by bit.
+
+bool DasmAvr8::BuildInstructionIndex()
 {
-for (int i = 0; i < _countof(AVR_Instruction_Set); i++)
+int i, j;
+memset(instIndex, NO_INSTRUCTION, sizeof(instIndex));
+for (i = _countof(AVR_Instruction_Set) - 1; i >= 0; i--)
   {
-  uint16_t instructionBits = opcode;
-
-  // Mask out the operands from the opcode
-  for (int j = 0; j < AVR_Instruction_Set[i].numOperands; j++)
-    instructionBits &= ~(AVR_Instruction_Set[i].operandMasks[j]);
-
-  // Compare left over instruction bits with the instruction mask
-  if (instructionBits == AVR_Instruction_Set[i].instructionMask)
-    return &AVR_Instruction_Set[i];
+  avrInstructionInfo &ii = AVR_Instruction_Set[i];
+  uint16_t vbits = 0;
+  for (j = 0; j < ii.numOperands; j++)
+    {
+    uint16_t mask = ii.operandMasks[j];
+    int bit, pos = 0, fld = -1;
+    vbits |= mask;
+    for (bit = 0; bit < 16; bit++)
+      {
+      if (!(mask & (1 << bit)))
+        continue;
+      if (fld < 0 || !(mask & (1 << (bit - 1))))
+        ii.operandFields[j][++fld].shift = (uint8_t)(bit - pos);
+      ii.operandFields[j][fld].mask |= (uint16_t)(1 << bit);
+      pos++;
+      }
+    }
+  if (ii.instructionMask & vbits)       /* can't match anything              */
+    continue;
+  uint16_t sub = 0;
+  do
+    {
+    instIndex[ii.instructionMask | sub] = (uint8_t)i;
+    sub = (uint16_t)((sub - vbits) & vbits);
+    } while (sub);
   }
-
-return NULL;
+return true;
 }
 
 /*****************************************************************************/
@@ -173,6 +173,12 @@ class Avr8RegLabelArray : public TAddrTypeArray<Avr8RegLabel>
 /* avrInstructionInfo : Structure for each entry in the instruction set      */
 /*****************************************************************************/
 
+struct avrOperandField                  /* contiguous bit field of operand   */
+  {
+  uint16_t mask;                        /* bits in the opcode                */
+  uint8_t shift;                        /* right shift to operand position   */
+  };
+
 struct avrInstructionInfo
   {
   uint8_t mnemonic;
@@ -181,6 +187,7 @@ struct avrInstructionInfo
   int16_t numOperands;
   uint16_t operandMasks[2];
   uint8_t operandTypes[2];
+  avrOperandField operandFields[2][3];  /* filled by BuildInstructionIndex   */
   };
 
 /*****************************************************************************/
@@ -212,7 +219,7 @@ class DasmAvr8 :
              (bus == BusEEPROM) ? 16 :
              0; }
     // return highest possible bus address
-    virtual caddr_t GetHighestBusAddr(int bus = BusCode) { return highaddr[bus]; }
+    virtual codeaddr_t GetHighestBusAddr(int bus = BusCode) { return highaddr[bus]; }
     // return the default memory type for a bus (used in loading)
     virtual MemoryType GetDefaultMemoryType(int bus = BusCode)
       { return (bus == BusCode) ? Code : Data; }
@@ -225,11 +232,11 @@ class DasmAvr8 :
     // return code pointer size in bytes
     virtual int GetCodePtrSize() { return 2; }
     // return highest possible code address
-    virtual caddr_t GetHighestCodeAddr() { return highaddr[BusCode]; }
+    virtual codeaddr_t GetHighestCodeAddr() { return highaddr[BusCode]; }
     // return data pointer size in bytes
     virtual int GetDataPtrSize() { return 2; }
     // return highest possible data address
-    virtual daddr_t GetHighestDataAddr() { return highaddr[BusData]; }
+    virtual dataaddr_t GetHighestDataAddr() { return highaddr[BusData]; }
 
     // Setup disassembler after construction
     virtual bool Setup();
@@ -292,7 +299,7 @@ class DasmAvr8 :
     virtual bool String2Number(string s, addr_t &value);
     virtual string Number2String(addr_t value, int nDigits, addr_t addr, int bus = BusCode);
     virtual string Address2String(addr_t addr, int bus = BusCode)
-      { return sformat("0x%0*x", (busbits[bus] + 3) / 4, addr); }
+      { string s("0x"); AppendHex(s, addr, (busbits[bus] + 3) / 4, false); return s; }
     string RegName(int regnum, bool with_label = true)
       {
       static const char *reghdr[] = { "R", "r" };
@@ -340,26 +347,23 @@ class DasmAvr8 :
           bits = busbits[bus];
           break;
         }
-      return sformat("%s%0*X", cType, (bits + 3) / 4, addr);
+      string s(cType);
+      AppendHex(s, addr, (bits + 3) / 4);
+      return s;
       }
 
   protected:
-    avrInstructionInfo *LookupInstruction(uint16_t opcode);
-    uint16_t GetMaskBits(uint16_t data, uint16_t mask)
+    avrInstructionInfo *LookupInstruction(uint16_t opcode)
       {
-      uint16_t result = 0;
-      int i, j;
-      /* Sweep through mask from bits 0 to 15 */
-      for (i = 0, j = 0; i < 16; i++)
-        {
-        if (mask & (1 << i))            /* if mask bit is set                */
-          {
-          if (data & (1 << i))          /* if data bit is set                */
-            result |= (1 << j);         /* set result bit                    */
-          j++;
-          }
-        }
-      return result;
+      uint8_t idx = instIndex[opcode];
+      return (idx == NO_INSTRUCTION) ? NULL : &AVR_Instruction_Set[idx];
+      }
+    uint16_t GetOperandBits(uint16_t data, avrInstructionInfo *ii, int opnd)
+      {
+      avrOperandField *f = ii->operandFields[opnd];
+      return (uint16_t)(((data & f[0].mask) >> f[0].shift) |
+                        ((data & f[1].mask) >> f[1].shift) |
+                        ((data & f[2].mask) >> f[2].shift));
       }
     int32_t DecodeOperand(uint32_t operand, uint8_t operandType);
     uint32_t GetDisassemblyTextFlags(addr_t addr, int bus = BusCode)
@@ -561,6 +565,26 @@ class DasmAvr8 :
 
     static OpCode opcodes[mnemoAvr8_count];
     static avrInstructionInfo AVR_Instruction_Set[];
+    enum { NO_INSTRUCTION = 0xff };
+    static uint8_t instIndex[65536];    /* opcode -> AVR_Instruction_Set idx */
+    static bool bInstIndexBuilt;
+    static bool BuildInstructionIndex();
+
+    // prerendered byte values for Number2String
+    enum ByteFormat
+      {
+      bfChar,                           /* character                         */
+      bfBinary,                         /* binary                            */
+      bfHex,                            /* hexadecimal                       */
+      bfDecimal,                        /* unsigned decimal                  */
+      bfSigned,                         /* signed decimal                    */
+
+      byteFormats_count
+      };
+    static char byteStrings[byteFormats_count][256][12];
+    static bool bByteStringsBuilt;
+    static bool BuildByteStrings();
+
     vector<addr_t> highaddr;
     Avr8RegLabelArray RegLabels;
     string CurRegLabel[32];
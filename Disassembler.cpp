@@ -98,7 +98,7 @@ if (plbl && plbl->IsUsed())
   {
   // labels containing '+' or '-' are no real labels; they are
   // references to another label (e.g., "OLBL+4")
-  string &s = plbl->GetText();
+  string s(plbl->GetText());
   if (s.find('-') == s.npos && s.find('+') == s.npos)
     wf |= SHMF_BREAK;
   }
@@ -116,6 +116,52 @@ static const uint16_t chkEnd = (((uint16_t)Disassembler::BigEndian) << 8) |
                                (uint16_t)Disassembler::LittleEndian;
 const Disassembler::Endian Disassembler::prgEndian = (Disassembler::Endian)*((uint8_t *)&chkEnd);
 
+// hex / ASCII dump translation tables
+const char Disassembler::hexDigits[17] = "0123456789ABCDEF";
+char Disassembler::dumpChars[256];
+bool Disassembler::bDumpCharsBuilt = Disassembler::BuildDumpChars();
+char Disassembler::byteStrings[byteFormats_count][256][12];
+bool Disassembler::bByteStringsBuilt = Disassembler::BuildByteStrings();
+
+/*****************************************************************************/
+/* BuildDumpChars : set up the byte to ASCII dump character translation      */
+/*****************************************************************************/
+
+bool Disassembler::BuildDumpChars()
+{
+for (int i = 0; i < 256; i++)
+  dumpChars[i] = isprint(i) ? (char)i : '.';
+return true;
+}
+
+/*****************************************************************************/
+/* BuildByteStrings : prerender all byte values in all display formats       */
+/*****************************************************************************/
+
+bool Disassembler::BuildByteStrings()
+{
+for (int i = 0; i < 256; i++)
+  {
+  string s[byteFormats_count];
+  if (isprint(i))
+    {
+    s[bfChar] = '\'';
+    s[bfChar] += (char)i;
+    s[bfCharClosed] = s[bfChar] + '\'';
+    }
+  else
+    s[bfCharClosed] = AppendHex(s[bfChar] = '$', i, 2, false);
+  AppendBin(s[bfBinary] = '%', i, 8);
+  AppendHex(s[bfHex] = '$', i, 2);
+  AppendOct(s[bfOctal] = '@', i, (2 * 4) + 2 / 3);
+  AppendDec(s[bfDecimal], i);
+  AppendSigned(s[bfSigned], (int8_t)i);
+  for (int fmt = 0; fmt < byteFormats_count; fmt++)
+    strcpy(byteStrings[fmt][i], s[fmt].c_str());
+  }
+return true;
+}
+
 /*****************************************************************************/
 /* Disassembler : constructor                                                */
 /*****************************************************************************/
@@ -137,6 +183,7 @@ bLoadLabel = true;
 bSetSysVec = true;
 bMultiLabel = false;
 bAutoLabel = false;
+bLabelTextCache = false;
 
 // set up options table
 // base class uses one generic option setter/getter pair (not mandatory)
@@ -183,6 +230,8 @@ Disassembler::~Disassembler()
 {
 for (int i = 0; i < GetOptionCount(); i++)
   delete options[i];
+for (vector<MemAttributeHandler *>::size_type bus = 0; bus < memattr.size(); bus++)
+  delete memattr[bus];
 }
 
 /*****************************************************************************/
@@ -197,6 +246,8 @@ busnames.resize(GetBusCount());
 memory.resize(GetBusCount());
 memattr.resize(GetBusCount());
 Labels.resize(GetBusCount());
+labelTexts[0].resize(GetBusCount());
+labelTexts[1].resize(GetBusCount());
 DefLabels.resize(GetBusCount());
 Relatives.resize(GetBusCount());
 Phases.resize(GetBusCount());
@@ -344,6 +395,7 @@ addr_t ivalue = (addr_t)strtoul(value.c_str(), NULL, 10);
 addr_t avalue;
 String2Number(value, avalue);
 int bnvalue = (lvalue == "off") ? 0 : (lvalue == "on") ? 1 : atoi(value.c_str());
+ClearLabelTexts();                      /* might influence label texts       */
 
 if (lname == "pbase" &&
          ivalue >= 2 && ivalue <= 16)
@@ -456,34 +508,52 @@ if (++hiaddr)
   Wrel %= hiaddr;
 // % might not be the best choice under all circumstances, but works for me...
 
-// NB: this always uses the LAST found label for this address.
-// There's no way to find out which should be used for multiples.
-Label *pLbl = (bUseLabel) ? FindLabel(Wrel, Untyped, bus) : NULL;
+Label *pLbl;
 string sLabel;
-// DefLabel is independent of bUseLabel and is used if no normal label is there
+LabelText lt;
+map<addr_t, LabelText> &cache = labelTexts[!!bUseLabel][bus];
+map<addr_t, LabelText>::iterator cit =
+    bLabelTextCache ? cache.find(Wrel) : cache.end();
+if (cit != cache.end())                 /* if target text already known      */
+  lt = cit->second;                     /* simply reuse it                   */
+else
+  {
+  // NB: this always uses the LAST found label for this address.
+  // There's no way to find out which should be used for multiples.
+  pLbl = (bUseLabel) ? FindLabel(Wrel, Untyped, bus) : NULL;
+  // DefLabel is independent of bUseLabel and is used if no normal label is there
 #if 1
-if (!pLbl)
-  pLbl = FindLabel(Wrel, Const, bus);
+  if (!pLbl)
+    pLbl = FindLabel(Wrel, Const, bus);
 #endif
-if (pLbl)                               /* get label name                    */
-  sLabel = pLbl->GetText();
-MemoryType memType = pLbl ? pLbl->GetType() : Untyped;
-if (pLbl && memType == Untyped)
-  memType = GetMemType(Wrel, bus);
-if (memType == Const || memType == Bss)
-  memType = Data;
+  if (pLbl)                             /* get label name                    */
+    lt.text = pLbl->GetText();
+  MemoryType memType = pLbl ? pLbl->GetType() : Untyped;
+  if (pLbl && memType == Untyped)
+    memType = GetMemType(Wrel, bus);
+  if (memType == Const || memType == Bss)
+    memType = Data;
+
+  if (lt.text.size())
+    lt.kind = ltNamed;
+  else if (bUseLabel && (memType == Code || memType == Data))
+    {
+    lt.kind = ltUnnamed;
+    lt.text = UnnamedLabel(Wrel, memType == Code, bus);
+    }
+  else                                  /* numeric output depends on addr    */
+    lt.kind = ltNumber;
+  if (bLabelTextCache)
+    cache[Wrel] = lt;
+  }
                                         /* if there and absolute             */
-if (Wrel == value && sLabel.size())
-  return sLabel;                        /* return it                         */
-
-if (sLabel.size())
-  sOut = sLabel;
-else if (bUseLabel && memType == Code)
-  sOut = UnnamedLabel(Wrel, true, bus);
-else if (bUseLabel && memType == Data)
-  sOut = UnnamedLabel(Wrel, false, bus);
+if (Wrel == value && lt.kind == ltNamed)
+  return lt.text;                       /* return it                         */
+
+if (lt.kind == ltNumber)
+  sOut = Number2String(Wrel, nDigits, addr, bus);
 else
-  sOut = Number2String(Wrel, nDigits, addr, bus).c_str();
+  sOut = lt.text;
 
 if (relative)                           /* if it's relative addressing       */
   {
@@ -547,6 +617,8 @@ bool Disassembler::AddLabel
     int bus
     )
 {
+LabelsChanged(bus);                     /* label texts might change          */
+
 #if 1
 LabelArray::iterator it;
 Label *pLbl = GetFirstLabel(addr, it, Untyped, bus);
@@ -764,6 +836,8 @@ for (int i = GetLabelCount(bus) - 1; i >= 0; i--)
     }
   }
 
+Labels[bus].BuildPrevNamed();           /* labels are final now              */
+bLabelTextCache = true;
 return true;
 }
 
@@ -802,7 +876,11 @@ Label *pLabel = FindPrevNamedLabel(addr, Untyped /* Const */, bus);
 if (pLabel)
   {
   addr_t off = addr - pLabel->GetAddress();
-  return sformat("O%x_%s", off, pLabel->GetText().c_str());
+  string s("O");
+  AppendHex(s, off, 0, false);
+  s += '_';
+  s += pLabel->GetText();
+  return s;
   }
 return "";
 }
@@ -1257,6 +1335,37 @@ return LoadIntelHex(filename, f, sLoadType, interleave, bus) ||
        LoadBinary(filename, f, sLoadType, interleave, bus);
 }
 
+/*****************************************************************************/
+/* LoadBuffer : loads a memory buffer as a binary                            */
+/*****************************************************************************/
+
+bool Disassembler::LoadBuffer
+    (
+    const uint8_t *data,
+    addr_t len,
+    addr_t addr,
+    int bus
+    )
+{
+if (!len || addr + len - 1 < addr ||    /* must fit into the bus             */
+    addr + len - 1 > GetHighestBusAddr(bus))
+  return false;
+
+if (!AddMemory(addr, len, GetDefaultMemoryType(bus), (uint8_t *)data, bus))
+  return false;
+for (addr_t i = 0; i < len; i++)        /* mark area as used                 */
+  {
+  SetCellUsed(addr + i, true, bus);
+  SetDisplay(addr + i, defaultDisplay, bus);
+  }
+
+if (addr < begin)                       /* adjust begin / end like hex files */
+  begin = addr;
+if (addr + len - 1 > end)
+  end = addr + len - 1;
+return true;
+}
+
 /*****************************************************************************/
 /* Load : loads a code file into the disassembler                            */
 /*****************************************************************************/
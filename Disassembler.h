@@ -216,15 +216,15 @@ class Disassembler
     // return code pointer size in bytes
     virtual int GetCodePtrSize() = 0;
     // return lowest possible code address
-    virtual caddr_t GetLowestCodeAddr() { return 0; }
+    virtual codeaddr_t GetLowestCodeAddr() { return 0; }
     // return highest possible code address
-    virtual caddr_t GetHighestCodeAddr() = 0;
+    virtual codeaddr_t GetHighestCodeAddr() = 0;
     // return data pointer size in bytes
     virtual int GetDataPtrSize() = 0;
     // return lowest possible data address
-    virtual daddr_t GetLowestDataAddr() { return 0; }
+    virtual dataaddr_t GetLowestDataAddr() { return 0; }
     // return highest possible data address
-    virtual daddr_t GetHighestDataAddr() = 0;
+    virtual dataaddr_t GetHighestDataAddr() = 0;
 
   // Setup disassembler after construction
     virtual bool Setup();
@@ -368,7 +368,7 @@ class Disassembler
       {
       string s;
       char c;
-      while ((c = (char)getat(addr++)) != cTerm)
+      while ((c = (char)GetUByte(addr++, bus)) != cTerm)
         s += c;
       return s;
       }
@@ -448,6 +448,8 @@ class Disassembler
       { addr_t *paddr = Relatives[bus].getat(addr); return paddr ? *paddr : 0; }
     void SetRelative(addr_t addr, addr_t rel, int bus = BusCode)
       { addr_t *paddr = Relatives[bus].getat(addr); if (paddr) *paddr = rel; }
+    void SetRelatives(addr_t from, addr_t to, addr_t rel, int bus = BusCode)
+      { Relatives[bus].fillat(from, to, rel); }
 
   // Phase handling
   public:
@@ -459,6 +461,8 @@ class Disassembler
       { TMemory<addr_t, addr_t> *pArea = FindPhase(addr, bus); return pArea ? pArea->GetType() : NO_ADDRESS; }
     void SetPhase(addr_t addr, addr_t phase = NO_ADDRESS, int bus = BusCode)
       { addr_t *paddr = Phases[bus].getat(addr); if (paddr) *paddr = phase; }
+    void SetPhases(addr_t from, addr_t to, addr_t phase = NO_ADDRESS, int bus = BusCode)
+      { Phases[bus].fillat(from, to, phase); }
     protected:
       addr_t PhaseInner(addr_t value, addr_t addr, int bus = BusCode)
         {
@@ -514,16 +518,25 @@ class Disassembler
       { return Labels[bus].GetFirst(addr, it, memType); }
     Label *GetNextLabel(addr_t addr, LabelArray::iterator &it, MemoryType memType = Untyped, int bus = BusCode)
       { return Labels[bus].GetNext(addr, it, memType); }
+    // GetFirstLabel(Untyped) for an ascending sweep through the labels
+    Label *GetFirstLabelSeq(addr_t addr, LabelArray::iterator &it, int bus = BusCode)
+      { return Labels[bus].GetFirstSeq(addr, it); }
     Label *FindLabel(addr_t addr, MemoryType memType = Untyped, int bus = BusCode);
     Label *FindPrevNamedLabel(addr_t addr, MemoryType memType = Untyped, int bus = BusCode);
     void RemoveLabel(addr_t addr, MemoryType memType = Untyped, int bus = BusCode)
       {
       LabelArray::iterator p = Labels[bus].find(addr, memType);
       if (p != Labels[bus].end()) Labels[bus].erase(p);
+      LabelsChanged(bus);
       }
     int GetLabelCount(int bus = BusCode) { return Labels[bus].size(); }
     Label *LabelAt(int index, int bus = BusCode) { return (Label *)Labels[bus].at(index); }
-    void RemoveLabelAt(int index, int bus = BusCode) { Labels[bus].erase(Labels[bus].begin() + index); }
+    void RemoveLabelAt(int index, int bus = BusCode) { Labels[bus].erase(Labels[bus].begin() + index); LabelsChanged(bus); }
+    void RemoveLabels(addr_t from, addr_t to, int bus = BusCode) { if (Labels[bus].eraserange(from, to)) LabelsChanged(bus); }
+    // rebuild a bus's labels in array order (e.g., from a stored parse)
+    void ClearLabels(int bus = BusCode) { Labels[bus].clear(); LabelsChanged(bus); }
+    void AppendLabel(addr_t addr, MemoryType memType, string sLabel, bool bUsed, int bus = BusCode)
+      { Labels[bus].push_back(new Label(addr, memType, sLabel, bUsed)); LabelsChanged(bus); }
     virtual bool ResolveLabels(int bus = BusCode);
     // convenience functionality for the above
     string GetLabel(addr_t addr, MemoryType memType = Untyped, int bus = BusCode)
@@ -609,11 +622,15 @@ class Disassembler
         { return DefLabels[bus].Find(addr); }
     int GetDefLabelCount(int bus = BusCode) { return DefLabels[bus].size(); }
     DefLabel *DefLabelAt(int index, int bus = BusCode) { return (DefLabel *)DefLabels[bus].at(index); }
+    void ClearDefLabels(int bus = BusCode) { DefLabels[bus].clear(); }
+    void AppendDefLabel(addr_t addr, MemoryType memType, string sLabel, string sDefinition, int bus = BusCode)
+      { DefLabels[bus].push_back(new DefLabel(addr, memType, sLabel, sDefinition)); }
 
   // File handling
   public:
     // load a code file; interleave can be >1 for interleaved Low/High EPROM pairs, for example
     bool Load(string filename, string &sLoadType, int interleave = 1, int bus = BusCode);
+    bool LoadBuffer(const uint8_t *data, addr_t len, addr_t addr, int bus = BusCode);
     // process an info file line
     virtual bool ProcessInfo(string key, string value, addr_t &from, addr_t &to, vector<TMemoryArray<addr_t>> &remaps, bool bProcInfo = true, int bus = BusCode, int tgtbus = BusCode) { return false; }
 
@@ -665,19 +682,22 @@ class Disassembler
     // create hex / ASCII representation of the current area
     virtual bool DisassembleHexAsc(addr_t addr, addr_t len, addr_t max, string &sHex, string &sAsc, int bus = BusCode)
       {
-      sAsc = "\'";
-      addr_t i;
-      for (i = 0; i < len; i++)
+      addr_t n = (len > max) ? len : max;
+      string::size_type hpos = sHex.size();
+      sHex.resize(hpos + n * 3, ' ');   /* padding is prefilled              */
+      sAsc.assign(n + 2, ' ');
+      sAsc[0] = '\'';
+      sAsc[len + 1] = '\'';
+      char *ph = &sHex[hpos];
+      char *pa = &sAsc[1];
+      const uint8_t *pb = GetSpan(addr, len, bus);
+      for (addr_t i = 0; i < len; i++)
         {
-        uint8_t c = GetUByte(addr + i, bus);
-        sHex += sformat("%02X ", c);
-        sAsc += (isprint(c)) ? c : '.'; 
-        }
-      sAsc += '\'';
-      for (; i < max; i++)
-        {
-        sHex += "   ";
-        sAsc += ' ';
+        uint8_t c = pb ? pb[i] : GetUByte(addr + i, bus);
+        ph[0] = hexDigits[c >> 4];
+        ph[1] = hexDigits[c & 0x0f];
+        ph += 3;
+        *pa++ = dumpChars[c];
         }
       return true;
       }
@@ -688,6 +708,14 @@ class Disassembler
     //
     TMemory<uint8_t, MemoryType> *FindMem(addr_t addr, int bus = BusCode)
       { return memory[bus].FindMem(addr); }
+    // get contiguous bytes at a given address (NULL if not in one area)
+    uint8_t *GetSpan(addr_t addr, addr_t len, int bus = BusCode)
+      {
+      TMemory<uint8_t, MemoryType> *pmem = FindMem(addr, bus);
+      if (!pmem || !len || addr + len - 1 > pmem->GetEnd())
+        return NULL;
+      return &pmem->at(addr);
+      }
     // fetch byte at a given address
     uint8_t *getat(addr_t addr, int bus = BusCode)
       { return memory[bus].getat(addr); }
@@ -796,7 +824,12 @@ class Disassembler
       else
 #endif
       // Only thing that should always work...
-      return sformat(IsSigned(addr, bus) ? "%d" : "%u", value);
+      string s;
+      if (IsSigned(addr, bus))
+        AppendSigned(s, (int32_t)value);
+      else
+        AppendDec(s, value);
+      return s;
       }
     virtual string SignedNumber2String(saddr_t value, int nDigits, addr_t addr, int bus = BusCode)
       {
@@ -810,7 +843,7 @@ class Disassembler
       return s + Number2String((addr_t)value, nDigits, addr, bus);
       }
     virtual string Address2String(addr_t addr, int bus = BusCode)
-      { return sformat("%d", addr); }
+      { string s; AppendSigned(s, (int32_t)addr); return s; }
     virtual string Label2String(addr_t value, int nDigits, bool bUseLabel, addr_t addr, int bus = BusCode);
     virtual string DefLabel2String(addr_t value, int nDigits, addr_t addr, int bus = BusCode);
     virtual string AutoLabel2String(addr_t addr, bool bCode, int bus = BusCode);
@@ -827,17 +860,67 @@ class Disassembler
 
       const char *cType = bCode ? "Z" : "M";
       int bits = busbits[bus];
-      return sformat("%s%0*X", cType, (bits + 3) / 4, addr);
+      string s(cType);
+      AppendHex(s, addr, (bits + 3) / 4);
+      return s;
       }
 
   protected:
     static const Endian prgEndian;
+    // hex / ASCII dump translation
+    static const char hexDigits[17];
+    static char dumpChars[256];
+    static bool bDumpCharsBuilt;
+    static bool BuildDumpChars();
+    // prerendered byte values in Motorola syntax for Number2String
+    enum ByteFormat
+      {
+      bfChar,                           /* character, open                   */
+      bfCharClosed,                     /* character, closed                 */
+      bfBinary,                         /* binary                            */
+      bfHex,                            /* hexadecimal                       */
+      bfOctal,                          /* octal                             */
+      bfDecimal,                        /* unsigned decimal                  */
+      bfSigned,                         /* signed decimal                    */
+
+      byteFormats_count
+      };
+    static char byteStrings[byteFormats_count][256][12];
+    static bool bByteStringsBuilt;
+    static bool BuildByteStrings();
     // For all [BusTypes] arrays below:
     // [0]: instruction bus; [1]: data bus, if separate; [2]: I/O bus, if separate
     vector<string> busnames;
     vector<MemoryArray> memory;
     vector<MemAttributeHandler *> memattr;
     vector<LabelArray> Labels;
+    // Label2String target text cache, [bUseLabel][bus]; active after
+    // ResolveLabels() and emptied whenever a label changes
+    enum LabelTextKind
+      {
+      ltNumber,                         /* no label, numeric output          */
+      ltNamed,                          /* named label                       */
+      ltUnnamed                         /* generated label name              */
+      };
+    struct LabelText
+      {
+      int kind;
+      string text;
+      };
+    vector<map<addr_t, LabelText> > labelTexts[2];
+    bool bLabelTextCache;
+    void ClearLabelTexts()
+      {
+      for (int i = 0; i < 2; i++)
+        for (vector<map<addr_t, LabelText> >::size_type b = 0; b < labelTexts[i].size(); b++)
+          labelTexts[i][b].clear();
+      }
+    // drop all information derived from a bus's labels
+    void LabelsChanged(int bus)
+      {
+      Labels[bus].ClearPrevNamed();
+      ClearLabelTexts();
+      }
     vector<DefLabelArray> DefLabels;
     vector<TMemoryArray<addr_t>> Relatives;
     vector<TMemoryArray<addr_t, addr_t>> Phases;
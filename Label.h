@@ -204,6 +204,58 @@ class AddrTypeArray : public vector<AddrType*>
     // convenience - find code and/or data labels
     iterator find(addr_t addr, MemoryType memType = Untyped, bool bTypeMatch = false)
       { return find(AddrType(addr, memType), bTypeMatch); }
+    // sequential search for the 1st element at an address, starting at a
+    // cursor that remembers the previous position; ascending sweeps are
+    // amortized O(1), anything else falls back to binary search
+    iterator findseq(addr_t addr, size_type &cursor)
+      {
+      size_type lo = 0, hi = size();
+      if (cursor <= hi &&
+          (!cursor || at(cursor - 1)->GetAddress() < addr))
+        {
+        lo = cursor;                    /* try a few steps from the cursor   */
+        for (int i = 0; i < 8 && lo < hi && at(lo)->GetAddress() < addr; i++)
+          lo++;
+        }
+      while (lo < hi && at(lo)->GetAddress() < addr)
+        {                               /* bisect the remainder              */
+        size_type mid = (lo + hi) / 2;
+        if (at(mid)->GetAddress() < addr)
+          lo = mid + 1;
+        else
+          hi = mid;
+        }
+      cursor = lo;
+      return (lo < size() && at(lo)->GetAddress() == addr) ? begin() + lo : end();
+      }
+    // index of the 1st element at or above an address
+    size_type lowerbound(addr_t addr)
+      {
+      size_type lo = 0, hi = size();
+      while (lo < hi)
+        {
+        size_type mid = (lo + hi) / 2;
+        if (at(mid)->GetAddress() < addr)
+          lo = mid + 1;
+        else
+          hi = mid;
+        }
+      return lo;
+      }
+    // index of the 1st element above an address
+    size_type upperbound(addr_t addr)
+      {
+      size_type lo = 0, hi = size();
+      while (lo < hi)
+        {
+        size_type mid = (lo + hi) / 2;
+        if (at(mid)->GetAddress() <= addr)
+          lo = mid + 1;
+        else
+          hi = mid;
+        }
+      return lo;
+      }
     // insert into address/type-sorted array
     iterator insert(AddrType *pNewEl, bool bAfter = true, bool bTypeMatch = false)
       {
@@ -293,6 +345,16 @@ class AddrTypeArray : public vector<AddrType*>
         }
       return vector<AddrType*>::erase(_First, _Last);
       }
+    // erase all elements in an address range
+    size_type eraserange(addr_t from, addr_t to)
+      {
+      if (to < from)
+        return 0;
+      size_type first = lowerbound(from), last = upperbound(to);
+      if (first < last)
+        erase(begin() + first, begin() + last);
+      return last - first;
+      }
 
 
   protected:
@@ -408,29 +470,52 @@ class Label : public AddrText
 class LabelArray : public TAddrTypeArray<Label>
   {
   public:
-    LabelArray(bool bMultipleDefs = false) : TAddrTypeArray<Label>(bMultipleDefs) { }
+    LabelArray(bool bMultipleDefs = false) : TAddrTypeArray<Label>(bMultipleDefs), seqPos(0), bPrevNamed(false) { }
 
     Label *GetFirst(addr_t addr, LabelArray::iterator &it, MemoryType memType = Untyped)
       {
       it = find(addr, memType);
       return (it != end()) ? (Label *)(*it) : NULL;
       }
+    // same as GetFirst(Untyped), optimized for an ascending address sweep
+    Label *GetFirstSeq(addr_t addr, LabelArray::iterator &it)
+      {
+      it = findseq(addr, seqPos);
+      return (it != end()) ? (Label *)(*it) : NULL;
+      }
     Label *GetPrevNamed(addr_t addr, LabelArray::iterator &it, MemoryType memType = Untyped)
       {
       // finds the named label of the given  type at this address or before
       if ((it = findimprec(addr)) == end())
         return NULL;
-      while (it != begin())
+      if (bPrevNamed)                   /* if precomputed, just look it up   */
+        it = begin() + prevNamed[memType][it - begin()];
+      else while (it != begin())
         {
-        Label *pLabel = (Label *)(*it);
-        MemoryType lblMemType = pLabel->GetType();
-        if (pLabel->HasText() &&
-            ((memType == Untyped && lblMemType != Const) || (memType == lblMemType)))
+        if (IsNamed((Label *)(*it), memType))
           break;
         it--;
         }
       return (it != end()) ? (Label *)(*it) : NULL;
       }
+    // precompute GetPrevNamed() results for all label indices and types;
+    // must be dropped with ClearPrevNamed() when the array changes
+    void BuildPrevNamed()
+      {
+      for (int t = Untyped; t <= IOPort; t++)
+        {
+        prevNamed[t].resize(size());
+        size_type last = 0;
+        for (size_type i = 0; i < size(); i++)
+          {
+          if (IsNamed(at(i), (MemoryType)t))
+            last = i;
+          prevNamed[t][i] = last;
+          }
+        }
+      bPrevNamed = true;
+      }
+    void ClearPrevNamed() { bPrevNamed = false; }
     // only makes sense if the label array allows multiples
     Label *GetNext(addr_t addr, LabelArray::iterator &it, MemoryType memType = Untyped)
       {
@@ -446,6 +531,19 @@ class LabelArray : public TAddrTypeArray<Label>
       LabelArray::iterator p;
       return GetFirst(addr, p, memType);
       }
+
+  protected:
+    static bool IsNamed(Label *pLabel, MemoryType memType)
+      {
+      MemoryType lblMemType = pLabel->GetType();
+      return pLabel->HasText() &&
+             ((memType == Untyped && lblMemType != Const) || (memType == lblMemType));
+      }
+
+  protected:
+    size_type seqPos;                   /* cursor for GetFirstSeq()          */
+    vector<size_type> prevNamed[IOPort + 1]; /* GetPrevNamed() results       */
+    bool bPrevNamed;                    /* flag whether prevNamed is valid   */
   };
 
 /*****************************************************************************/
@@ -45,6 +45,16 @@ e) if not code (or data reference / constant in code),
 template<class T, class TType = uint8_t> class TMemory : public vector<T>
   {
   public:
+    // dependent base class names, for compilers doing two-phase lookup
+    typedef typename vector<T>::size_type size_type;
+    typedef typename vector<T>::reference reference;
+    typedef typename vector<T>::const_reference const_reference;
+    using vector<T>::size;
+    using vector<T>::resize;
+    using vector<T>::assign;
+    using vector<T>::begin;
+    using vector<T>::end;
+
     TMemory(addr_t addrStart = 0, addr_t memSize = 0, TType newType = (TType)0)
       : memType(newType)
       {
@@ -95,10 +105,20 @@ template<class T, class TType = uint8_t>
     class TMemoryArray : public vector<TMemory<T, TType>>
   {
   public:
+    // dependent base class names, for compilers doing two-phase lookup
+    typedef typename vector<TMemory<T, TType>>::size_type size_type;
+    typedef typename vector<TMemory<T, TType>>::iterator iterator;
+    using vector<TMemory<T, TType>>::size;
+    using vector<TMemory<T, TType>>::at;
+    using vector<TMemory<T, TType>>::begin;
+    using vector<TMemory<T, TType>>::end;
+    using vector<TMemory<T, TType>>::insert;
+    using vector<TMemory<T, TType>>::erase;
+
     TMemoryArray() { ResetLast(); }
     bool AddMemory(addr_t addrStart = 0, addr_t memSize = 0, TType memType = (TType)0, T *contents = NULL)
       {
-      vector<TMemory<T, TType>>::iterator i;
+      iterator i;
       if (memSize)
         {
         addr_t addrEnd = addrStart + memSize - 1;
@@ -176,7 +196,7 @@ template<class T, class TType = uint8_t>
       {
       // little speedup for multiple accesses in scattered environments
       if (addr >= last.start && addr <= last.end) return last.idx;
-      for (TMemoryArray<T, TType>::size_type i = 0; i < size(); i++)
+      for (size_type i = 0; i < size(); i++)
         {
         TMemory<T, TType> &mem = at(i);
         if (mem.GetStart() <= addr && (addr_t)(mem.GetStart() + mem.size()) > addr)
@@ -234,6 +254,21 @@ template<class T, class TType = uint8_t>
       pmem->at(addr) = val;
       return true;
       }
+    // write an item to all existing cells in an address range
+    void fillat(addr_t from, addr_t to, T val)
+      {
+      for (size_type i = 0; i < size(); i++)
+        {
+        TMemory<T, TType> &mem = at(i);
+        addr_t start = mem.GetStart(), end = mem.GetEnd();
+        if (start > to || end < from)
+          continue;
+        if (start < from) start = from;
+        if (end > to) end = to;
+        for (addr_t j = start - mem.GetStart(); j <= end - mem.GetStart(); j++)
+          mem.at(mem.GetStart() + j) = val;
+        }
+      }
     // write multiple bytes with(out) byte reversal
     bool setat(addr_t addr, T *val, addr_t len, bool bReverse = false) 
       {
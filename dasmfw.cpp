@@ -26,6 +26,19 @@
 #include "Label.h"
 #include "Memory.h"
 
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _MSC_VER
+#define NOMINMAX
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 /*****************************************************************************/
 /* Global Data                                                               */
 /*****************************************************************************/
@@ -90,6 +103,28 @@ Disassemblers[nRegDisassemblers++].Factory = CreateDisassembler;
 return true;
 }
 
+/*****************************************************************************/
+/* RegisterAllDisassemblers : registers all built-in disassemblers           */
+/*****************************************************************************/
+
+static bool bAllRegistered = false;     /* flag whether backends registered  */
+
+bool RegisterAllDisassemblers()
+{
+if (!bAllRegistered)
+  bAllRegistered = RegisterDasm6800() &&
+                   RegisterDasm6801() &&
+                   RegisterDasm6301() &&
+                   RegisterDasm6809() &&
+                   RegisterDasm6309() &&
+                   RegisterDasm68000() &&
+                   RegisterDasmAvr8();
+return bAllRegistered;
+}
+
+// done during static initialization, i.e., before any worker thread exists
+static bool bRegistered = RegisterAllDisassemblers();
+
 /*****************************************************************************/
 /* CreateDisassembler : creates a disassembler with a given code name        */
 /*****************************************************************************/
@@ -140,9 +175,18 @@ for (int da = 0; da < nRegDisassemblers; da++)
 
 string sformat(const string fmt_str, ...)
 {
-int final_n, n = ((int)fmt_str.size()) * 2;
-vector<char> formatted;
+char sbuf[256];                         /* try without allocation first      */
 va_list ap;
+va_start(ap, fmt_str);
+int final_n = vsnprintf(sbuf, sizeof(sbuf), fmt_str.c_str(), ap);
+va_end(ap);
+if (final_n >= 0 && final_n < (int)sizeof(sbuf))
+  return string(sbuf);
+
+int n = ((int)fmt_str.size()) * 2;
+if (n < final_n + 1)
+  n = final_n + 1;
+vector<char> formatted;
 while (1)
   {
   formatted.resize(n);
@@ -157,6 +201,74 @@ while (1)
 return string(&formatted[0]);
 }
 
+/*****************************************************************************/
+/* Append... : fast number formatting                                        */
+/*****************************************************************************/
+
+// These are used on the hot paths instead of sformat(); they append the
+// digits to the passed string without any temporary allocations.
+// nDigits is the minimum number of digits, like the width in "%0*x".
+
+static string &AppendDigits(string &s, const char *p, const char *end, int nDigits)
+{
+int nLen = (int)(end - p);
+if (nDigits > nLen)
+  s.append(nDigits - nLen, '0');
+return s.append(p, nLen);
+}
+
+string &AppendHex(string &s, uint32_t value, int nDigits, bool bUpper)
+{
+static const char *digits[2] = { "0123456789abcdef", "0123456789ABCDEF" };
+const char *hex = digits[!!bUpper];
+char buf[16], *end = buf + sizeof(buf), *p = end;
+do
+  {
+  *--p = hex[value & 0x0f];
+  value >>= 4;
+  } while (value);
+return AppendDigits(s, p, end, nDigits);
+}
+
+string &AppendOct(string &s, uint32_t value, int nDigits)
+{
+char buf[16], *end = buf + sizeof(buf), *p = end;
+do
+  {
+  *--p = (char)('0' + (value & 0x07));
+  value >>= 3;
+  } while (value);
+return AppendDigits(s, p, end, nDigits);
+}
+
+string &AppendDec(string &s, uint32_t value, int nDigits)
+{
+char buf[16], *end = buf + sizeof(buf), *p = end;
+do
+  {
+  *--p = (char)('0' + (value % 10));
+  value /= 10;
+  } while (value);
+return AppendDigits(s, p, end, nDigits);
+}
+
+string &AppendSigned(string &s, int32_t value)
+{
+if (value < 0)
+  {
+  s += '-';
+  return AppendDec(s, (uint32_t)0 - (uint32_t)value);
+  }
+return AppendDec(s, (uint32_t)value);
+}
+
+string &AppendBin(string &s, uint32_t value, int nBits)
+{
+for (int nBit = nBits - 1; nBit >= 0; nBit--)
+  s += (char)('0' + (!!(value & (1 << nBit))));
+return s;
+}
+
 /*****************************************************************************/
 /* lowercase : create lowercase copy of a string                             */
 /*****************************************************************************/
@@ -210,174 +322,1013 @@ return s.substr(from, s.find_last_not_of(" ") - from + 1);
 }
 
 /*****************************************************************************/
-/* main : main program function                                              */
+/* KeywordTable : constructor                                                */
 /*****************************************************************************/
 
-int main(int argc, char* argv[])
+KeywordTable::KeywordTable(const Keyword *keys, int nKeys)
 {
-// let's go object-oriented, shall we? :-)
-Application app(argc, argv);
-return app.Run();
+uint32_t size = 8;                      /* keep the table at most half full  */
+while (size < (uint32_t)nKeys * 2)
+  size <<= 1;
+slots.resize(size, NULL);
+mask = size - 1;
+for (int i = 0; i < nKeys; i++)         /* earlier entries take precedence   */
+  {
+  uint32_t h = Hash(keys[i].name, strlen(keys[i].name)) & mask;
+  while (slots[h])
+    h = (h + 1) & mask;
+  slots[h] = &keys[i];
+  }
 }
 
+/*****************************************************************************/
+/* Hash : FNV-1a hash over a keyword                                         */
+/*****************************************************************************/
+
+uint32_t KeywordTable::Hash(const char *s, string::size_type len)
+{
+uint32_t h = 2166136261U;
+for (string::size_type i = 0; i < len; i++)
+  {
+  h ^= (uint8_t)s[i];
+  h *= 16777619U;
+  }
+return h;
+}
 
+/*****************************************************************************/
+/* Find : find the command type for a keyword                                */
+/*****************************************************************************/
 
-/*===========================================================================*/
-/* Application class members                                                 */
-/*===========================================================================*/
+int KeywordTable::Find(const string &key, int notFound) const
+{
+uint32_t h = Hash(key.data(), key.size()) & mask;
+while (slots[h])
+  {
+  if (key == slots[h]->name)
+    return slots[h]->cmdType;
+  h = (h + 1) & mask;
+  }
+return notFound;
+}
 
 /*****************************************************************************/
-/* Application : constructor                                                 */
+/* Threading helpers                                                         */
 /*****************************************************************************/
 
-Application::Application(int argc, char* argv[])
-  : argc(argc), argv(argv)
+struct WorkerStart                      /* what a new thread has to do       */
+  {
+  WorkerFunc pFunc;
+  void *pArg;
+  };
 
-{
-pDasm = NULL;                           /* selected disassembler             */
-iDasm = -1;                             /* index of selected disassembler    */
-abortHelp = false;                      /* abort after help has been given   */
-infoBus = BusCode;                      /* start with code bus               */
-showHex = true;                         /* flag for hex data display         */
-showAddr = true;                        /* flag for address display          */
-showComments = true;                    /* flag for comment display          */
-f9dasmComp = false;                     /* flag for f9dasm compatibility     */
-labelLen = 8;                           /* minimum label length              */
-lLabelLen = 8;                          /* minimum EQU label length          */
-mnemoLen = 8;                           /* minimum mnemonics length          */
-cparmLen = 24;                          /* min parm len with lcomment        */
-uparmLen = 52;                          /* max parm len without lcomment     */
-dbCount = 5;                            /* min code bytes for hex/asc dump   */
-#if RB_VARIANT
-showAsc = false;                        /* flag for ASCII content display    */
+#ifdef _MSC_VER
+static unsigned __stdcall WorkerThread(void *pStart)
 #else
-showAsc = true;                         /* flag for ASCII content display    */
+static void *WorkerThread(void *pStart)
 #endif
-showUnused = false;                     /* don't show unused labels          */
-out = stdout;
-
-// pre-load matching disassembler, if possible
-sDasmName = argv[0];
-string::size_type idx = sDasmName.find_last_of("\\/");
-if (idx != sDasmName.npos)
-  sDasmName = sDasmName.substr(idx + 1);
-idx = sDasmName.rfind('.');
-if (idx != sDasmName.npos)
-  sDasmName = sDasmName.substr(0, idx);
-// if the name might be "dasm"+code, try to use this disassembler
-if (lowercase(sDasmName.substr(0, 4)) == "dasm")
-  pDasm = CreateDisassembler(sDasmName.substr(4), &iDasm);
+{
+WorkerStart ws = *(WorkerStart *)pStart;
+delete (WorkerStart *)pStart;
+ws.pFunc(ws.pArg);
+return 0;
+}
 
-printf("%s: Disassembler Framework V%s\n", sDasmName.c_str(), DASMFW_VERSION);
+// starts a thread; *pHandle receives its handle, NULL means detached
+static bool CreateWorker(WorkerFunc pFunc, void *pArg, void **pHandle)
+{
+WorkerStart *pStart = new WorkerStart;
+pStart->pFunc = pFunc;
+pStart->pArg = pArg;
+#ifdef _MSC_VER
+// _beginthreadex, not CreateThread, so that the C runtime is set up
+HANDLE h = (HANDLE)_beginthreadex(NULL, 0, WorkerThread, pStart, 0, NULL);
+bool bOK = !!h;
+if (h && pHandle)
+  *pHandle = h;
+else if (h)
+  CloseHandle(h);
+#else
+pthread_t *pt = new pthread_t;
+bool bOK = !pthread_create(pt, NULL, WorkerThread, pStart);
+if (bOK && pHandle)
+  *pHandle = pt;
+else
+  {
+  if (bOK)
+    pthread_detach(*pt);
+  delete pt;
+  }
+#endif
+if (!bOK)
+  delete pStart;
+return bOK;
 }
 
-/*****************************************************************************/
-/* ~Application : destructor                                                 */
-/*****************************************************************************/
+static void JoinWorker(void *handle)
+{
+#ifdef _MSC_VER
+WaitForSingleObject((HANDLE)handle, INFINITE);
+CloseHandle((HANDLE)handle);
+#else
+pthread_join(*(pthread_t *)handle, NULL);
+delete (pthread_t *)handle;
+#endif
+}
 
-Application::~Application()
+void RunWorkers(int nThreads, WorkerFunc pFunc, void *pArg)
 {
+vector<void *> handles;
+for (int i = 0; i < nThreads; i++)
+  {
+  void *handle;
+  if (CreateWorker(pFunc, pArg, &handle))
+    handles.push_back(handle);
+  }
+if (handles.empty())                    /* no threads? do it here, then.     */
+  pFunc(pArg);
+for (vector<void *>::size_type i = 0; i < handles.size(); i++)
+  JoinWorker(handles[i]);
 }
 
-/*****************************************************************************/
-/* Run : the application's main functionality                                */
-/*****************************************************************************/
+bool StartWorker(WorkerFunc pFunc, void *pArg)
+{
+return CreateWorker(pFunc, pArg, NULL);
+}
 
-int Application::Run()
+long FetchAndAdd(volatile long *pValue, long n)
 {
-if (argc < 2)                           /* if no arguments given, give help  */
-  return Help();                        /* and exit                          */
+#ifdef _MSC_VER
+return InterlockedExchangeAdd(pValue, n);
+#else
+return __sync_fetch_and_add(pValue, n);
+#endif
+}
 
-string defnfo[2];                       /* global / user default info files  */
+int CountProcessors()
+{
 #ifdef _MSC_VER
-// Microsoft C - guaranteed Windows environment
-char const *pHomePath = getenv("USERPROFILE");
-defnfo[0] = pHomePath ?
-    string(pHomePath) + "\\.dasmfw\\" + sDasmName + ".nfo" :
-    "";
+SYSTEM_INFO si;
+GetSystemInfo(&si);
+return (int)si.dwNumberOfProcessors;
 #else
-char const *pHomePath = getenv("HOME");
-defnfo[0] = pHomePath ?
-    string(pHomePath) + "/.dasmfw/" + sDasmName + ".nfo" :
-    "";
+long n = sysconf(_SC_NPROCESSORS_ONLN);
+return (n > 0) ? (int)n : 1;
 #endif
-defnfo[1] = sDasmName + ".nfo";
+}
 
-int i;
-int bus;
-                                        /* first, just search for "dasm"     */
-for (i = 0; i < _countof(defnfo); i++)
-  if (!defnfo[i].empty())
-    ParseOption("info", defnfo[i], true, false);
-ParseOptions(argc, argv, true);
-if (!pDasm)                             /* disassembler must be loaded now   */
-  return Help();                        /* if not, display help & exit       */
+#ifdef _MSC_VER
 
-remaps.resize(pDasm->GetBusCount());    /* set up all arrays                 */
-comments[0].resize(pDasm->GetBusCount());
-comments[1].resize(pDasm->GetBusCount());
-lcomments.resize(pDasm->GetBusCount());
+Mutex::Mutex()
+{
+pImpl = new CRITICAL_SECTION;
+InitializeCriticalSection((CRITICAL_SECTION *)pImpl);
+}
 
-                                        /* then parse all other options      */
-for (i = 0; i < _countof(defnfo); i++)  /* for data & info files to load     */
-  if (!defnfo[i].empty())
-    ParseOption("info", defnfo[i], false, false);
-ParseOptions(argc, argv, false);
+Mutex::~Mutex()
+{
+DeleteCriticalSection((CRITICAL_SECTION *)pImpl);
+delete (CRITICAL_SECTION *)pImpl;
+}
 
-if (abortHelp)                          /* help has been given, so end it    */
-  return 1;
+void Mutex::Lock() { EnterCriticalSection((CRITICAL_SECTION *)pImpl); }
+void Mutex::Unlock() { LeaveCriticalSection((CRITICAL_SECTION *)pImpl); }
 
-LoadFiles();                            /* load all data files               */
+Semaphore::Semaphore(int nInitial)
+{
+pImpl = CreateSemaphore(NULL, nInitial, 0x7fffffff, NULL);
+}
 
-LoadInfoFiles();                        /* load all info files               */
+Semaphore::~Semaphore() { CloseHandle((HANDLE)pImpl); }
+void Semaphore::Wait() { WaitForSingleObject((HANDLE)pImpl, INFINITE); }
+void Semaphore::Post() { ReleaseSemaphore((HANDLE)pImpl, 1, NULL); }
 
-// parse labels in 2 passes
-for (i = 0; i < pDasm->GetBusCount(); i++)
+#else
+
+Mutex::Mutex()
+{
+pImpl = new pthread_mutex_t;
+pthread_mutex_init((pthread_mutex_t *)pImpl, NULL);
+}
+
+Mutex::~Mutex()
+{
+pthread_mutex_destroy((pthread_mutex_t *)pImpl);
+delete (pthread_mutex_t *)pImpl;
+}
+
+void Mutex::Lock() { pthread_mutex_lock((pthread_mutex_t *)pImpl); }
+void Mutex::Unlock() { pthread_mutex_unlock((pthread_mutex_t *)pImpl); }
+
+// POSIX semaphores aren't available everywhere (unnamed ones are missing
+// on OS X), so this is done with a mutex and a condition variable
+struct PosixSemaphore
   {
-  bus = pDasm->GetBus(i);
-  if (pDasm->GetMemoryArrayCount(bus)) Parse(0, bus);
-  }
-for (i = 0; i < pDasm->GetBusCount(); i++)
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  int count;
+  };
+
+Semaphore::Semaphore(int nInitial)
+{
+PosixSemaphore *ps = new PosixSemaphore;
+pthread_mutex_init(&ps->mutex, NULL);
+pthread_cond_init(&ps->cond, NULL);
+ps->count = nInitial;
+pImpl = ps;
+}
+
+Semaphore::~Semaphore()
+{
+PosixSemaphore *ps = (PosixSemaphore *)pImpl;
+pthread_cond_destroy(&ps->cond);
+pthread_mutex_destroy(&ps->mutex);
+delete ps;
+}
+
+void Semaphore::Wait()
+{
+PosixSemaphore *ps = (PosixSemaphore *)pImpl;
+pthread_mutex_lock(&ps->mutex);
+while (ps->count <= 0)
+  pthread_cond_wait(&ps->cond, &ps->mutex);
+ps->count--;
+pthread_mutex_unlock(&ps->mutex);
+}
+
+void Semaphore::Post()
+{
+PosixSemaphore *ps = (PosixSemaphore *)pImpl;
+pthread_mutex_lock(&ps->mutex);
+ps->count++;
+pthread_cond_signal(&ps->cond);
+pthread_mutex_unlock(&ps->mutex);
+}
+
+#endif
+
+#ifndef DASMFW_NO_MAIN                  /* not needed in the library build   */
+
+/*****************************************************************************/
+/* SplitArgs : splits a job line into command line arguments                 */
+/*****************************************************************************/
+
+static void SplitArgs(const string &line, vector<string> &args)
+{
+string::size_type i = 0;
+while (i < line.size())
   {
-  bus = pDasm->GetBus(i);
-  if (pDasm->GetMemoryArrayCount(bus)) Parse(1, bus);
+  while (i < line.size() && (line[i] == ' ' || line[i] == '\t' ||
+                             line[i] == '\r' || line[i] == '\n'))
+    i++;
+  if (i >= line.size())
+    break;
+  string arg;
+  while (i < line.size() && line[i] != ' ' && line[i] != '\t' &&
+         line[i] != '\r' && line[i] != '\n')
+    {
+    if (line[i] == '\"' || line[i] == '\'')
+      {                                 /* quoted part, may contain blanks   */
+      char delim = line[i++];
+      while (i < line.size() && line[i] != delim)
+        arg += line[i++];
+      if (i < line.size())
+        i++;
+      }
+    else
+      arg += line[i++];
+    }
+  args.push_back(arg);
   }
+}
 
-// resolve all XXXXXXXX+/-nnnn labels and DefLabels
-for (i = 0; i < pDasm->GetBusCount(); i++)
+/*****************************************************************************/
+/* JobOptions : collects the values given for an option on a job's command   */
+/*****************************************************************************/
+
+// accepts "-option value", "-option=value" and "-option:value", like
+// Application::ParseOptions()
+
+static void JobOptions(const vector<string> &args, string option, vector<string> &values)
+{
+option = "-" + option;
+for (vector<string>::size_type i = 1; i < args.size(); i++)
   {
-  bus = pDasm->GetBus(i);
-  pDasm->ResolveLabels(bus);
+  if (args[i] == option && i + 1 < args.size())
+    values.push_back(args[++i]);
+  else if (args[i].size() > option.size() &&
+           !args[i].compare(0, option.size(), option) &&
+           (args[i][option.size()] == '=' || args[i][option.size()] == ':'))
+    values.push_back(args[i].substr(option.size() + 1));
   }
+}
 
-// set up often used texts and flags
-string labelDelim = pDasm->GetOption("ldchar");
-string sComDel = pDasm->GetOption("cchar");
-string sComBlk = sComDel + " ";
-string sComHdr(sComDel);
-while (sComHdr.size() < 53)
-  sComHdr += '*';
+/*****************************************************************************/
+/* RunJob : runs a job command line in an Application of its own             */
+/*****************************************************************************/
 
-// create output file
-out = outname.size() ? fopen(outname.c_str(), "w") : stdout;
-if (out == NULL)
-  out = stdout;
-if (out != stdout)                      /* if output goes to file            */
-  {                                     /* write header details              */
-  PrintLine(sComDel +
-            sformat(" %s: Disassembler Framework V" DASMFW_VERSION,
-                    sDasmName.c_str()));
-  for (i = 0;                           /* print loaded files                */
-       i < (int)saFNames.size();
-       i++)
-    if (saFNames[i].substr(0, 1) != "-")
-      PrintLine(sComDel + " " + saFNames[i]);
-  for (i = 0;                           /* print loaded info files           */
-       i < (int)saINames.size();
-       i++)
-  PrintLine(sComDel + " " + saINames[i]);
-  PrintLine();
-  }
+// Status messages of a job that runs next to others are collected, so that
+// they can be written out in one piece.
+
+struct JobMessages : public MessageSink
+  {
+  string text;
+  virtual void Message(const string &s) { text += s; text += '\n'; }
+  };
+
+struct JobListing : public ListingSink
+  {
+  string text;
+  virtual bool Line(const ListingLine &, const string &s)
+    { text += s; text += '\n'; return true; }
+  };
+
+static int RunJob
+    (
+    vector<string> &args,
+    const Application::InfoCache *pShared,
+    MessageSink *pMsgs,
+    ListingSink *pLines = NULL
+    )
+{
+vector<char *> jobArgv;
+for (vector<string>::size_type i = 0; i < args.size(); i++)
+  jobArgv.push_back(&args[i][0]);
+jobArgv.push_back(NULL);
+
+Application app((int)args.size(), &jobArgv[0]);
+app.SetSharedInfo(pShared);
+app.SetMessageSink(pMsgs);
+app.SetListingSink(pLines);
+return app.Run();
+}
+
+/*****************************************************************************/
+/* ServeJobs : runs one disassembly job per line read from stdin             */
+/*****************************************************************************/
+
+// "dasmfw -server [-threads n] [common options]" reads newline-delimited
+// job requests, each one a dasmfw command line without the program name.
+// The common options are prepended to each job. Every job runs in a fresh
+// Application with its own disassembler instance, so only the static tables
+// built at startup are shared. Up to n jobs (default: one per processor)
+// run at the same time; reading stdin waits while all of them are busy.
+// When a job is done, its status messages, its listing if it has no -out
+// file, and a line "<<< dasmfw job n done: rc" are written in one piece,
+// and stdout is flushed. Jobs can finish out of order; n is the number of
+// the request line. Jobs writing to the console can't use -snapshot, since
+// their listing is collected through a ListingSink.
+
+struct ServerContext
+  {
+  ServerContext(int nSlots) : slots(nSlots) { }
+  Semaphore slots;                      /* free job slots                    */
+  Mutex outLock;                        /* serializes job results on stdout  */
+  };
+
+struct ServerJob
+  {
+  ServerContext *pCtx;
+  vector<string> args;                  /* job command line                  */
+  int nJob;                             /* job (request line) number         */
+  };
+
+static void RunServerJob(void *pArg)
+{
+ServerJob *pJob = (ServerJob *)pArg;
+ServerContext *pCtx = pJob->pCtx;
+
+vector<string> outNames;                /* listing to console: collect it    */
+JobOptions(pJob->args, "out", outNames);
+bool bCollect = outNames.empty() || outNames.back() == "console";
+JobMessages msgs;
+JobListing listing;
+int rc = RunJob(pJob->args, NULL, &msgs, bCollect ? &listing : NULL);
+
+pCtx->outLock.Lock();
+fwrite(msgs.text.data(), 1, msgs.text.size(), stdout);
+fwrite(listing.text.data(), 1, listing.text.size(), stdout);
+printf("<<< dasmfw job %d done: %d\n", pJob->nJob, rc);
+fflush(stdout);
+pCtx->outLock.Unlock();
+
+delete pJob;
+pCtx->slots.Post();                     /* last access to the context        */
+}
+
+static int ServeJobs(int argc, char* argv[])
+{
+int nThreads = CountProcessors();
+int arg = 2;
+if (arg + 1 < argc && !strcmp(argv[arg], "-threads"))
+  {
+  nThreads = atoi(argv[arg + 1]);
+  arg += 2;
+  }
+if (nThreads < 1)
+  nThreads = 1;
+vector<string> common;
+for (; arg < argc; arg++)
+  common.push_back(argv[arg]);
+
+ServerContext ctx(nThreads);
+int nJob = 0;
+string line;
+char chunk[4096];
+while (fgets(chunk, sizeof(chunk), stdin))
+  {
+  line += chunk;
+  if (line[line.size() - 1] != '\n' && !feof(stdin))
+    continue;                           /* collect overlong lines            */
+
+  vector<string> args(1, argv[0]);
+  args.insert(args.end(), common.begin(), common.end());
+  string::size_type nCommon = args.size();
+  SplitArgs(line, args);
+  line.clear();
+  if (args.size() == nCommon)           /* ignore empty lines                */
+    continue;
+
+  ServerJob *pJob = new ServerJob;
+  pJob->pCtx = &ctx;
+  pJob->args.swap(args);
+  pJob->nJob = ++nJob;
+  ctx.slots.Wait();                     /* wait for a free slot              */
+  if (!StartWorker(RunServerJob, pJob)) /* no thread? do it here, then.      */
+    RunServerJob(pJob);
+  }
+
+for (int i = 0; i < nThreads; i++)      /* wait for the running jobs         */
+  ctx.slots.Wait();
+return 0;
+}
+
+/*****************************************************************************/
+/* Batch mode : runs a manifest of jobs on a pool of worker threads          */
+/*****************************************************************************/
+
+// "dasmfw -batch manifest [-threads n] [common options]" runs one job per
+// manifest line, each a dasmfw command line. The common options are
+// prepended to each job, so a job can override them. Every job has to name
+// an -out file of its own; jobs without one, or with one that an earlier
+// job already writes to, are rejected. Info files named by -info in the
+// jobs or the common options, and the files they INCLUDE, are compiled
+// once and shared by all jobs. Idle workers take the next unstarted job,
+// so long jobs don't hold up others. When all are done, each job's status
+// messages are written, followed by "<<< dasmfw job n done: rc".
+
+struct BatchContext
+  {
+  vector<vector<string> > jobs;         /* job command lines (empty: reject) */
+  vector<int> rcs;                      /* job return codes                  */
+  vector<JobMessages> messages;         /* job status messages               */
+  const Application::InfoCache *pShared;/* info files compiled for all jobs  */
+  volatile long nextJob;                /* next job to be started            */
+  };
+
+static void RunBatchJobs(void *pArg)
+{
+BatchContext *pCtx = (BatchContext *)pArg;
+long nJobs = (long)pCtx->jobs.size();
+for (long j = FetchAndAdd(&pCtx->nextJob);
+     j < nJobs;
+     j = FetchAndAdd(&pCtx->nextJob))
+  {
+  if (pCtx->jobs[j].size())
+    pCtx->rcs[j] = RunJob(pCtx->jobs[j], pCtx->pShared, &pCtx->messages[j]);
+  }
+}
+
+// compiles an info file and everything it includes into the shared cache
+static void ShareInfo(string fileName, Application::InfoCache &shared)
+{
+if (shared.find(fileName) != shared.end())
+  return;
+FILE *fp = fopen(fileName.c_str(), "r");
+if (!fp)
+  return;
+string text;
+char chunk[16384];
+size_t nRead;
+while ((nRead = fread(chunk, 1, sizeof(chunk), fp)) > 0)
+  text.append(chunk, nRead);
+fclose(fp);
+
+vector<Application::InfoLine> &lines = shared[fileName];
+Application::SplitInfo(text, lines);
+for (vector<Application::InfoLine>::size_type i = 0; i < lines.size(); i++)
+  {
+  if (lines[i].key != "INCLUDE")
+    continue;
+  ShareInfo(Application::InfoFileName(lines[i].value), shared);
+  }
+}
+
+static void ShareJobInfo(const vector<string> &args, Application::InfoCache &shared)
+{
+vector<string> infos;
+JobOptions(args, "info", infos);
+for (vector<string>::size_type i = 0; i < infos.size(); i++)
+  ShareInfo(infos[i], shared);
+}
+
+static int RunBatch(int argc, char* argv[])
+{
+if (argc < 3)
+  {
+  printf("Usage: %s -batch manifest [-threads n] [-option]*\n", argv[0]);
+  return 1;
+  }
+FILE *fp = fopen(argv[2], "r");
+if (!fp)
+  {
+  printf("NOT loaded: batch manifest \"%s\"\n", argv[2]);
+  return 1;
+  }
+
+int nThreads = CountProcessors();
+int arg = 3;
+if (arg + 1 < argc && !strcmp(argv[arg], "-threads"))
+  {
+  nThreads = atoi(argv[arg + 1]);
+  arg += 2;
+  }
+vector<string> common(1, argv[0]);
+for (; arg < argc; arg++)
+  common.push_back(argv[arg]);
+
+BatchContext ctx;
+string line;
+char chunk[4096];
+while (fgets(chunk, sizeof(chunk), fp))
+  {
+  line += chunk;
+  if (line[line.size() - 1] != '\n' && !feof(fp))
+    continue;                           /* collect overlong lines            */
+  vector<string> args(common);
+  SplitArgs(line, args);
+  line.clear();
+  if (args.size() > common.size())      /* ignore empty lines                */
+    ctx.jobs.push_back(args);
+  }
+fclose(fp);
+
+ctx.rcs.resize(ctx.jobs.size(), 0);
+ctx.messages.resize(ctx.jobs.size());
+map<string, int> outs;                  /* output file -> job writing it     */
+for (vector<vector<string> >::size_type i = 0; i < ctx.jobs.size(); i++)
+  {
+  vector<string> outNames;              /* the last -out given counts        */
+  JobOptions(ctx.jobs[i], "out", outNames);
+  string outName(outNames.size() ? outNames.back() : "");
+  if (outName.empty() || outName == "console")
+    ctx.messages[i].Message("Job rejected: no -out file");
+  else if (outs.find(outName) != outs.end())
+    ctx.messages[i].Message(sformat("Job rejected: -out \"%s\" is used by job %d",
+                                    outName.c_str(), outs[outName]));
+  else
+    {
+    outs[outName] = (int)i + 1;
+    continue;
+    }
+  ctx.jobs[i].clear();
+  ctx.rcs[i] = 1;
+  }
+
+Application::InfoCache shared;          /* compile shared info files once    */
+for (vector<vector<string> >::size_type i = 0; i < ctx.jobs.size(); i++)
+  ShareJobInfo(ctx.jobs[i], shared);
+ctx.pShared = &shared;
+ctx.nextJob = 0;
+
+if (nThreads < 1)
+  nThreads = 1;
+if (nThreads > (int)ctx.jobs.size())
+  nThreads = (int)ctx.jobs.size();
+RunWorkers(nThreads, RunBatchJobs, &ctx);
+
+int nFailed = 0;
+for (vector<int>::size_type i = 0; i < ctx.rcs.size(); i++)
+  {
+  printf("%s", ctx.messages[i].text.c_str());
+  printf("<<< dasmfw job %d done: %d\n", (int)i + 1, ctx.rcs[i]);
+  if (ctx.rcs[i])
+    nFailed++;
+  }
+return nFailed ? 1 : 0;
+}
+
+/*****************************************************************************/
+/* main : main program function                                              */
+/*****************************************************************************/
+
+int main(int argc, char* argv[])
+{
+if (argc > 1 && !strcmp(argv[1], "-server"))
+  return ServeJobs(argc, argv);
+if (argc > 1 && !strcmp(argv[1], "-batch"))
+  return RunBatch(argc, argv);
+
+// let's go object-oriented, shall we? :-)
+Application app(argc, argv);
+return app.Run();
+}
+
+#endif // DASMFW_NO_MAIN
+
+
+
+/*****************************************************************************/
+/* HashBytes : FNV-1a hash over a memory range                               */
+/*****************************************************************************/
+
+static uint32_t HashBytes(const void *data, size_t len, uint32_t h = 2166136261U)
+{
+const uint8_t *p = (const uint8_t *)data;
+for (size_t i = 0; i < len; i++)
+  h = (h ^ p[i]) * 16777619U;
+return h;
+}
+
+/*****************************************************************************/
+/* PutU32 / GetU32 / PutString / GetString : little-endian binary fields     */
+/*****************************************************************************/
+
+static void PutU32(string &s, uint32_t v)
+{
+for (int i = 0; i < 4; i++, v >>= 8)
+  s += (char)(v & 0xff);
+}
+
+static bool GetU32(const string &s, string::size_type &pos, uint32_t &v)
+{
+if (pos + 4 > s.size())
+  return false;
+v = 0;
+for (int i = 3; i >= 0; i--)
+  v = (v << 8) | (uint8_t)s[pos + i];
+pos += 4;
+return true;
+}
+
+static void PutString(string &s, const string &txt)
+{
+PutU32(s, (uint32_t)txt.size());
+s += txt;
+}
+
+static bool GetString(const string &s, string::size_type &pos, string &txt)
+{
+uint32_t len;
+if (!GetU32(s, pos, len) || pos + len > s.size())
+  return false;
+txt.assign(s, pos, len);
+pos += len;
+return true;
+}
+
+/*===========================================================================*/
+/* OutputSink class members                                                  */
+/*===========================================================================*/
+
+/*****************************************************************************/
+/* Open : open an output file or the console                                 */
+/*****************************************************************************/
+
+bool OutputSink::Open(string fileName)
+{
+Close();
+buf.clear();
+fp = fileName.size() ? fopen(fileName.c_str(), "w") : stdout;
+return !!fp;
+}
+
+/*****************************************************************************/
+/* Flush : write out pending output                                          */
+/*****************************************************************************/
+
+bool OutputSink::Flush()
+{
+if (!fp)
+  return false;
+bool bOK = !buf.size() ||
+           fwrite(buf.data(), 1, buf.size(), fp) == buf.size();
+CopyOut(buf.data(), buf.size());
+buf.clear();
+return bOK;
+}
+
+/*****************************************************************************/
+/* Write : write out a block of text directly, bypassing the buffer          */
+/*****************************************************************************/
+
+bool OutputSink::Write(const char *data, size_t len)
+{
+if (!fp)
+  return false;
+bool bOK = Flush();
+bOK &= fwrite(data, 1, len, fp) == len;
+CopyOut(data, len);
+return bOK;
+}
+
+/*****************************************************************************/
+/* CopyOut : write output to the copy file, if there is one                  */
+/*****************************************************************************/
+
+void OutputSink::CopyOut(const char *data, size_t len)
+{
+if (!fpCopy || !len)
+  return;
+bCopyOK &= fwrite(data, 1, len, fpCopy) == len;
+copyHash = HashBytes(data, len, copyHash);
+copySize += (uint32_t)len;
+}
+
+/*****************************************************************************/
+/* Close : flush pending output and close the output file                    */
+/*****************************************************************************/
+
+bool OutputSink::Close()
+{
+bool bOK = Flush();
+if (fp && fp != stdout)
+  fclose(fp);
+else if (fp)
+  fflush(fp);
+fp = NULL;
+return bOK;
+}
+
+/*===========================================================================*/
+/* CommentArray class members                                                */
+/*===========================================================================*/
+
+/*****************************************************************************/
+/* DeferredLess : sort order for deferred comments                           */
+/*****************************************************************************/
+
+// Within an address, prepended comments come first, the last one prepended
+// in front; appended ones follow in the order they were deferred.
+
+bool CommentArray::DeferredLess(const Deferred &a, const Deferred &b)
+{
+if (a.pEl->GetAddress() != b.pEl->GetAddress())
+  return a.pEl->GetAddress() < b.pEl->GetAddress();
+if (a.bAfter != b.bAfter)
+  return !a.bAfter;
+return a.bAfter ? (a.seq < b.seq) : (a.seq > b.seq);
+}
+
+/*****************************************************************************/
+/* Merge : merge deferred comments into the array                            */
+/*****************************************************************************/
+
+void CommentArray::Merge()
+{
+if (deferred.empty())
+  return;
+
+sort(deferred.begin(), deferred.end(), DeferredLess);
+
+vector<AddrType*> merged;
+merged.reserve(size() + deferred.size());
+size_type i = 0, j = 0;
+while (i < size() || j < deferred.size())
+  {
+  // existing comments go behind prepended and before appended ones
+  if (j >= deferred.size() ||
+      (i < size() &&
+       (at(i)->GetAddress() < deferred[j].pEl->GetAddress() ||
+        (at(i)->GetAddress() == deferred[j].pEl->GetAddress() &&
+         deferred[j].bAfter))))
+    merged.push_back(at(i++));
+  else
+    merged.push_back(deferred[j++].pEl);
+  }
+vector<AddrType*>::swap(merged);
+deferred.clear();
+seqPos = 0;
+}
+
+/*===========================================================================*/
+/* Application class members                                                 */
+/*===========================================================================*/
+
+/*****************************************************************************/
+/* Application : constructor                                                 */
+/*****************************************************************************/
+
+Application::Application(int argc, char* argv[])
+  : argc(argc), argv(argv)
+
+{
+RegisterAllDisassemblers();             /* make sure backends are known      */
+pDasm = NULL;                           /* selected disassembler             */
+iDasm = -1;                             /* index of selected disassembler    */
+abortHelp = false;                      /* abort after help has been given   */
+infoBus = BusCode;                      /* start with code bus               */
+showHex = true;                         /* flag for hex data display         */
+showAddr = true;                        /* flag for address display          */
+showComments = true;                    /* flag for comment display          */
+f9dasmComp = false;                     /* flag for f9dasm compatibility     */
+incOnce = false;                        /* load info files only once         */
+labelLen = 8;                           /* minimum label length              */
+lLabelLen = 8;                          /* minimum EQU label length          */
+mnemoLen = 8;                           /* minimum mnemonics length          */
+cparmLen = 24;                          /* min parm len with lcomment        */
+uparmLen = 52;                          /* max parm len without lcomment     */
+dbCount = 5;                            /* min code bytes for hex/asc dump   */
+#if RB_VARIANT
+showAsc = false;                        /* flag for ASCII content display    */
+#else
+showAsc = true;                         /* flag for ASCII content display    */
+#endif
+showUnused = false;                     /* don't show unused labels          */
+outFormat = ofText;                     /* normal assembler listing          */
+pSink = NULL;                           /* no embedding listing sink         */
+pMsgSink = NULL;                        /* status messages go to stdout      */
+bSinkDone = false;
+pSharedInfo = NULL;                     /* no info shared with other jobs    */
+parseKey = 0;
+bULHOut = false;                        /* no label headers output yet       */
+bUDHOut = false;
+
+// pre-load matching disassembler, if possible
+sDasmName = argv[0];
+string::size_type idx = sDasmName.find_last_of("\\/");
+if (idx != sDasmName.npos)
+  sDasmName = sDasmName.substr(idx + 1);
+idx = sDasmName.rfind('.');
+if (idx != sDasmName.npos)
+  sDasmName = sDasmName.substr(0, idx);
+// if the name might be "dasm"+code, try to use this disassembler
+if (lowercase(sDasmName.substr(0, 4)) == "dasm")
+  pDasm = CreateDisassembler(sDasmName.substr(4), &iDasm);
+}
+
+/*****************************************************************************/
+/* ~Application : destructor                                                 */
+/*****************************************************************************/
+
+Application::~Application()
+{
+delete pDasm;                           /* Run() may end at any point        */
+}
+
+/*****************************************************************************/
+/* Message : output a status message                                         */
+/*****************************************************************************/
+
+void Application::Message(const string &text)
+{
+if (pMsgSink)                           /* embedded: let the caller decide   */
+  pMsgSink->Message(text);
+else
+  printf("%s\n", text.c_str());
+}
+
+/*****************************************************************************/
+/* Run : the application's main functionality                                */
+/*****************************************************************************/
+
+int Application::Run()
+{
+Message(sformat("%s: Disassembler Framework V%s", sDasmName.c_str(), DASMFW_VERSION));
+if (argc < 2)                           /* if no arguments given, give help  */
+  return Help();                        /* and exit                          */
+
+string defnfo[2];                       /* global / user default info files  */
+#ifdef _MSC_VER
+// Microsoft C - guaranteed Windows environment
+char const *pHomePath = getenv("USERPROFILE");
+defnfo[0] = pHomePath ?
+    string(pHomePath) + "\\.dasmfw\\" + sDasmName + ".nfo" :
+    "";
+#else
+char const *pHomePath = getenv("HOME");
+defnfo[0] = pHomePath ?
+    string(pHomePath) + "/.dasmfw/" + sDasmName + ".nfo" :
+    "";
+#endif
+defnfo[1] = sDasmName + ".nfo";
+
+int i;
+int bus;
+                                        /* the info cache is needed before   */
+for (i = 1; i < argc; i++)              /* the first info file is read       */
+  if (!strcmp(argv[i], "-infocache") && i + 1 < argc)
+    infoCacheDir = argv[i + 1];
+  else if (!strncmp(argv[i], "-infocache=", 11) ||
+           !strncmp(argv[i], "-infocache:", 11))
+    infoCacheDir = argv[i] + 11;
+                                        /* first, just search for "dasm"     */
+for (i = 0; i < _countof(defnfo); i++)
+  if (!defnfo[i].empty())
+    ParseOption("info", defnfo[i], true, false);
+ParseOptions(argc, argv, true);
+if (!pDasm)                             /* disassembler must be loaded now   */
+  return Help();                        /* if not, display help & exit       */
+
+remaps.resize(pDasm->GetBusCount());    /* set up all arrays                 */
+comments[0].resize(pDasm->GetBusCount());
+comments[1].resize(pDasm->GetBusCount());
+lcomments.resize(pDasm->GetBusCount());
+
+                                        /* then parse all other options      */
+for (i = 0; i < _countof(defnfo); i++)  /* for data & info files to load     */
+  if (!defnfo[i].empty())
+    ParseOption("info", defnfo[i], false, false);
+ParseOptions(argc, argv, false);
+
+if (abortHelp)                          /* help has been given, so end it    */
+  return 1;
+
+if (pSink)                              /* a sink needs the listing records, */
+  snapName.clear();                     /* so it can't work with a snapshot  */
+if (snapName.size())                    /* if working with a snapshot        */
+  {
+  snapHeader = SnapshotHeader();
+  if (RestoreSnapshot())                /* inputs unchanged: output is done  */
+    return 0;
+  }
+
+LoadFiles();                            /* load all data files               */
+
+LoadInfoFiles();                        /* load all info files               */
+if (infoCacheDir.size())                /* keep them compiled for next time  */
+  WriteInfoCache();
+if (snapName.size())                    /* label names may change for reuse  */
+  SaveInfoLabels();
+
+if (!RestoreParse())                    /* unless the snapshot has it,       */
+  {
+  // parse labels in 2 passes
+  for (i = 0; i < pDasm->GetBusCount(); i++)
+    {
+    bus = pDasm->GetBus(i);
+    if (pDasm->GetMemoryArrayCount(bus)) Parse(0, bus);
+    }
+  for (i = 0; i < pDasm->GetBusCount(); i++)
+    {
+    bus = pDasm->GetBus(i);
+    if (pDasm->GetMemoryArrayCount(bus)) Parse(1, bus);
+    }
+  }
+if (snapName.size())                    /* keep the result for the snapshot  */
+  SaveParse();
+
+// resolve all XXXXXXXX+/-nnnn labels and DefLabels
+for (i = 0; i < pDasm->GetBusCount(); i++)
+  {
+  bus = pDasm->GetBus(i);
+  pDasm->ResolveLabels(bus);
+  }
+
+// set up often used texts and flags
+string labelDelim = pDasm->GetOption("ldchar");
+string sComDel = pDasm->GetOption("cchar");
+string sComBlk = sComDel + " ";
+string sComHdr(sComDel);
+while (sComHdr.size() < 53)
+  sComHdr += '*';
+
+// create output file
+if (!out.Open(outname))
+  out.Open();
+if (snapName.size())                    /* snapshot gets a copy of output    */
+  {
+  string snapStart(snapHeader);
+  PutU32(snapStart, parseKey);
+  PutString(snapStart, parseState);
+  FILE *fpSnap = fopen(snapName.c_str(), "wb");
+  if (fpSnap &&
+      fwrite(snapStart.data(), 1, snapStart.size(), fpSnap) != snapStart.size())
+    {
+    fclose(fpSnap);
+    fpSnap = NULL;
+    }
+  if (fpSnap)
+    out.CopyTo(fpSnap, HashBytes(snapStart.data(), snapStart.size()));
+  else
+    remove(snapName.c_str());
+  }
+if (!out.IsConsole())                   /* if output goes to file            */
+  {                                     /* write header details              */
+  PrintLine(sComDel +
+            sformat(" %s: Disassembler Framework V" DASMFW_VERSION,
+                    sDasmName.c_str()));
+  for (i = 0;                           /* print loaded files                */
+       i < (int)saFNames.size();
+       i++)
+    if (saFNames[i].substr(0, 1) != "-")
+      PrintLine(sComDel + " " + saFNames[i]);
+  for (i = 0;                           /* print loaded info files           */
+       i < (int)saINames.size();
+       i++)
+  PrintLine(sComDel + " " + saINames[i]);
+  PrintLine();
+  }
 
 //#ifdef _DEBUG
 #if 0
@@ -401,6 +1352,7 @@ for (i = 0; i < pDasm->GetBusCount(); i++)
 DisassembleChanges(NO_ADDRESS, NO_ADDRESS, 0, false, 0);
 
 // output of (def)labels without data
+bULHOut = bUDHOut = false;              /* headers once per run, all busses  */
 for (i = 0; i < pDasm->GetBusCount(); i++)
   {
   bus = pDasm->GetBus(i);
@@ -453,9 +1405,10 @@ for (i = 0; i < pDasm->GetBusCount(); i++)
 // disassembler-specific closing
 DisassembleChanges(NO_ADDRESS, NO_ADDRESS, 0, true, pDasm->GetBusCount());
 
-if (out != stdout)
-  fclose(out);
-if (pDasm) delete pDasm;
+RenderListing();                        /* now create the text output        */
+out.Close();
+if (snapName.size())                    /* complete the snapshot             */
+  SaveSnapshot();
 return 0;
 }
 
@@ -495,15 +1448,28 @@ for (int i = 0;                         /* load file(s) given on commandline */
     if (nInterleave != 1)
       saFNames[i] += sformat(" (interleave=%d)", nInterleave);
 #ifndef _DEBUG
-    printf("%s\n", saFNames[i].c_str());
+    Message(saFNames[i]);
 #endif
     bAllOK &= bOK;
     }
 #ifdef _DEBUG
-  printf("%s\n", saFNames[i].c_str());
+  Message(saFNames[i]);
 #endif
   }
 
+for (vector<LoadBuffer>::size_type i = 0; i < loadBuffers.size(); i++)
+  {                                     /* load in-memory data areas         */
+  LoadBuffer &lb = loadBuffers[i];
+  int bus = (lb.bus < pDasm->GetBusCount()) ? lb.bus : BusCode;
+  bool bOK = lb.data.size() &&
+             pDasm->LoadBuffer(&lb.data[0], lb.data.size(), lb.addr, bus);
+  Message(sformat("%soaded: memory buffer (%u bytes at %s)",
+                  bOK ? "L" : "NOT l",
+                  (unsigned)lb.data.size(),
+                  pDasm->Address2String(lb.addr, bus).c_str()));
+  bAllOK &= bOK;
+  }
+
 return bAllOK;
 }
 
@@ -525,13 +1491,27 @@ for (int i = 0;
   saINames[i] = sformat("%soaded: Info file \"%s\"",
                          bOK ? "L" : "NOT l",
                          saINames[i].c_str());
-  printf("%s\n", saINames[i].c_str());
+  Message(saINames[i]);
   bAllOK &= bOK;
   }
 
 return bAllOK;
 }
 
+/*****************************************************************************/
+/* MergeComments : merge all deferred comments into their arrays             */
+/*****************************************************************************/
+
+void Application::MergeComments()
+{
+for (int bus = 0; bus < (int)lcomments.size(); bus++)
+  {
+  comments[0][bus].Merge();
+  comments[1][bus].Merge();
+  lcomments[bus].Merge();
+  }
+}
+
 /*****************************************************************************/
 /* Parse : go through the loaded memory areas and parse all labels           */
 /*****************************************************************************/
@@ -562,7 +1542,10 @@ while (addr != NO_ADDRESS)
     if (nct == MemAttribute::CellUntyped)
       {
       if (nPass == 0)
+        {
         AddLComment(addr, "Illegal instruction!", false, bus);
+        illegalInsts.push_back(make_pair(addr, bus));
+        }
       }
     }
   prevaddr = addr;
@@ -592,7 +1575,9 @@ while (pComment)
   string sTxt(pComment->GetText());
   string sHdr((pComment->IsComment() && sTxt.size()) ? sComDel : "");
   if (showComments || !pComment->IsComment())
-    PrintLine(sHdr + sTxt);
+    AddLine(ListingLine(pComment->IsComment() ? ListingLine::lkComment :
+                                                ListingLine::lkInsert,
+                        addr, 0, bus, sHdr + sTxt));
   pComment = GetNextComment(addr, it, bAfterLine, bus);
   }
 return true;
@@ -622,7 +1607,8 @@ for (vector<Disassembler::LineChange>::size_type i = 0;
      i < changes.size();
      i++)
   {
-  PrintLine(changes[i].label, changes[i].oper, changes[i].opnds);
+  AddLine(ListingLine(ListingLine::lkChange, addr, 0, bus,
+                      changes[i].label, changes[i].oper, changes[i].opnds));
   }
 return bRC;
 }
@@ -641,7 +1627,6 @@ bool Application::DisassembleLabels
 string sComBlk(sComDel + " ");
 CommentArray::iterator it;
 Comment *pComment;
-static bool bULHOut = false;
 addr_t paddr = NO_ADDRESS;
 for (int l = 0; l < pDasm->GetLabelCount(bus); l++)
   {
@@ -676,216 +1661,841 @@ for (int l = 0; l < pDasm->GetLabelCount(bus); l++)
                      GetFirstLComment(laddr, it, bus) : NULL;
       string scomment = pComment ? pComment->GetText() : "";
       if (scomment.size()) scomment = sComBlk + scomment;
-      PrintLine(slabel, smnemo, sparm, scomment, lLabelLen);
+      ListingLine line(ListingLine::lkLabel, laddr, 0, bus,
+                       slabel, smnemo, sparm, scomment, lLabelLen);
+      if (pComment)
+        line.slcomment = pComment->GetText();
+      AddLine(line);
       if (pComment)
         {
         while ((pComment = GetNextLComment(laddr, it, bus)) != NULL)
-          PrintLine("", "", "", sComBlk + pComment->GetText());
+          AddLineComment(laddr, sComBlk, pComment->GetText(), bus);
         }
 
       // comments after line
       if (laddr != paddr)
         DisassembleComments(laddr, true, sComDel, bus);
 
-      paddr = laddr;
-      }
+      paddr = laddr;
+      }
+    }
+  }
+
+return true;
+}
+
+/*****************************************************************************/
+/* DisassembleDefLabels : disassemble all used DefLabels                     */
+/*****************************************************************************/
+
+bool Application::DisassembleDefLabels
+    (
+    string sComDel,
+    string sComHdr,
+    int bus
+    )
+{
+string sComBlk(sComDel + " ");
+
+for (int l = 0; l < pDasm->GetDefLabelCount(bus); l++)
+  {
+  DefLabel *pLbl = pDasm->DefLabelAt(l, bus);
+  string slabel, smnemo, sparm;
+  // DefLabels got no comments ATM
+  if (pLbl &&
+      pDasm->DisassembleDefLabel(pLbl, slabel, smnemo, sparm, bus))
+    {
+    // header, if not yet done
+    if (!bUDHOut)
+      {
+      PrintLine();
+      PrintLine(sComHdr);
+      PrintLine(sComBlk + "Used Definitions");
+      PrintLine(sComHdr);
+      PrintLine();
+      bUDHOut = true;
+      }
+    // and no line comments
+    AddLine(ListingLine(ListingLine::lkDefLabel, NO_ADDRESS, 0, bus,
+                        slabel, smnemo, sparm, "", lLabelLen));
+    }
+  }
+
+return true;
+}
+
+/*****************************************************************************/
+/* DisassembleLine : create a line of disassembler output (+comments)        */
+/*****************************************************************************/
+
+addr_t Application::DisassembleLine
+    (
+    addr_t addr,
+    string sComDel,
+    string sComHdr,
+    string labelDelim,
+    int bus
+    )
+{
+string sLabel, sMnemo, sParms, sComBlk(sComDel + " ");
+CommentArray::iterator it;
+Comment *pComment;
+bool bWithComments = showHex || showAsc || showAddr;
+
+// comments before line
+DisassembleComments(addr, false, sComDel, bus);
+
+// the line itself
+// in case of multiple labels, it's always the last one that's used
+// for the "real" code/data line, so prepend all others
+LabelArray::iterator lit;
+Label *p = NULL, *pNext = pDasm->GetFirstLabelSeq(addr, lit, bus);
+while (pNext)
+  {
+  if (pNext->IsUsed() && !pNext->IsConst())
+    p = pNext;
+  pNext = pDasm->GetNextLabel(addr, lit, Untyped, bus);
+  // multiple labels get their own lines
+  if (p != pNext && pNext && pNext->IsUsed() && !pNext->IsConst())
+    {
+    string s = p->GetText();
+    if (s.size())
+      AddLine(ListingLine(ListingLine::lkLabel, addr, 0, bus, s + labelDelim));
+    }
+  }
+if (p && p->IsUsed() && !p->IsConst())
+  sLabel = pDasm->Label2String(addr, 4, true, addr, bus) +
+           labelDelim;
+pComment = showComments ? GetFirstLComment(addr, it, bus) : NULL;
+int maxparmlen = (bWithComments || pComment) ? (cparmLen - 1) : uparmLen;
+addr_t sz = pDasm->Disassemble(addr, sMnemo, sParms, maxparmlen, bus);
+
+string scomment;
+if (showAddr)
+  scomment += sformat("%0*X%s",
+                      (pDasm->BusAddressBits(bus) + 3) / 4, addr,
+                      (showHex || showAsc) ? ": " : " ");
+if ((showHex || showAsc) && !pDasm->IsBss(addr, bus))
+  {
+  string sHex, sAsc;
+  if (showHex || showAsc)
+    {
+    pDasm->DisassembleHexAsc(addr, sz, (addr_t)dbCount, sHex, sAsc, bus);
+    if (!pComment)
+      sAsc = trim(sAsc);
+#if 0
+    for (addr_t i = sz; i < (addr_t)dbCount; i++)
+      {
+      if (showHex && showAsc)
+        sHex += "   ";
+      if (showAsc && pComment)
+        sAsc += ' ';
+      }
+#endif
+    }
+
+  if (showHex)
+    scomment += sHex;
+  if (showAsc)
+    scomment += sAsc;
+  }
+if (pComment && pComment->GetText().size())
+  {
+  if (scomment.size()) scomment += " ";
+  scomment += pComment->GetText();
+  }
+if (scomment.size()) scomment = sComBlk + scomment;
+ListingLine line((pDasm->GetMemType(addr, bus) == Code) ?
+                     ListingLine::lkCode : ListingLine::lkData,
+                 addr, sz, bus, sLabel, sMnemo, sParms, scomment);
+if (pComment)
+  line.slcomment = pComment->GetText();
+AddLine(line);
+if (pComment)
+  {
+// following line comments
+  while ((pComment = GetNextLComment(addr, it, bus)) != NULL)
+    AddLineComment(addr, sComBlk, pComment->GetText(), bus);
+  }
+
+// comments after line
+DisassembleComments(addr, true, sComDel, bus);
+
+return sz;
+}
+
+/*****************************************************************************/
+/* Snapshot helpers                                                          */
+/*****************************************************************************/
+
+// A snapshot keeps the rendered output of a run together with what it has
+// been made from; if the command line and all data and info files are still
+// the same, the output can be written without disassembling anything.
+// If only comment directives or label names have changed, the state after
+// Parse() is taken from the snapshot, so only the listing has to be redone.
+//
+//   "DFWSNAP4"                         magic
+//   uint32 argHash                     version, build and command line
+//   uint32 nFiles                      input files, each with
+//     uint32 nameLen, name               file name
+//     uint32 size, hash                  contents (size 0xffffffff: missing)
+//                                        (AddLoadBuffer() data areas are
+//                                        listed as "memory buffer n")
+//   uint32 parseKey                    hash over all inputs of Parse()
+//   uint32 stateLen, state             state after Parse() (see SaveParse())
+//   text                               rendered output
+//   uint32 textLen                     size of the rendered output
+//   uint32 hash                        FNV-1a over all of the above
+//
+// The text is written while the output is generated, so its size comes
+// after it.
+
+static const char snapMagic[] = "DFWSNAP4";
+
+static bool ReadWholeFile(string fileName, string &data)
+{
+FILE *fp = fopen(fileName.c_str(), "rb");
+if (!fp)
+  return false;
+char chunk[16384];
+size_t nRead;
+data.clear();
+while ((nRead = fread(chunk, 1, sizeof(chunk), fp)) > 0)
+  data.append(chunk, nRead);
+fclose(fp);
+return true;
+}
+
+// reads the input file list from a snapshot header
+typedef map<string, pair<uint32_t, uint32_t> > SnapFiles;
+static bool GetSnapFiles(const string &s, string::size_type &pos, SnapFiles &files)
+{
+uint32_t nFiles, size, hash;
+if (!GetU32(s, pos, nFiles))
+  return false;
+string name;
+for (uint32_t i = 0; i < nFiles; i++)
+  {
+  if (!GetString(s, pos, name) ||
+      !GetU32(s, pos, size) || !GetU32(s, pos, hash))
+    return false;
+  files[name] = make_pair(size, hash);
+  }
+return true;
+}
+
+/*****************************************************************************/
+/* SnapshotHeader : creates the input description for the snapshot          */
+/*****************************************************************************/
+
+// Needs to be called after the options have been parsed, since that's
+// where the data and info files are collected. Sets up parseKey, too.
+
+string Application::SnapshotHeader()
+{
+string hdr(snapMagic, 8);
+
+// the version number is not bumped for every change in the output, so the
+// build time is part of the key, too; a rebuilt program never trusts a
+// snapshot written by an older one
+static const char buildId[] = DASMFW_VERSION " " __DATE__ " " __TIME__;
+uint32_t h = HashBytes(buildId, strlen(buildId));
+for (int arg = 1; arg < argc; arg++)
+  h = HashBytes(argv[arg], strlen(argv[arg]) + 1, h);
+PutU32(hdr, h);
+
+vector<string> names;
+for (vector<string>::size_type i = 0; i < saFNames.size(); i++)
+  if (saFNames[i].substr(0, 1) != "-")
+    names.push_back(saFNames[i]);
+vector<string>::size_type nData = names.size();
+for (map<string, int>::const_iterator ii = infoLoaded.begin();
+     ii != infoLoaded.end();
+     ii++)
+  {
+  names.push_back(ii->first);
+  h = InfoParseHash(ii->first, h);      /* info files minus their comments   */
+  }
+
+PutU32(hdr, (uint32_t)(names.size() + loadBuffers.size()));
+string data;
+for (vector<string>::size_type i = 0; i < names.size(); i++)
+  {
+  PutString(hdr, names[i]);
+  map<string, string>::const_iterator ti = infoTexts.find(names[i]);
+  if (ti != infoTexts.end())
+    data = ti->second;
+  if (ti != infoTexts.end() || ReadWholeFile(names[i], data))
+    {
+    PutU32(hdr, (uint32_t)data.size());
+    PutU32(hdr, HashBytes(data.data(), data.size()));
+    }
+  else
+    {
+    PutU32(hdr, 0xffffffff);
+    PutU32(hdr, 0);
+    }
+  if (i < nData)                        /* data files are parsed as a whole  */
+    h = HashBytes(hdr.data() + hdr.size() - 8, 8,
+                  HashBytes(names[i].data(), names[i].size(), h));
+  }
+for (vector<LoadBuffer>::size_type i = 0; i < loadBuffers.size(); i++)
+  {                                     /* in-memory data areas, too         */
+  const LoadBuffer &lb = loadBuffers[i];
+  string name(sformat("memory buffer %u", (unsigned)i));
+  uint32_t lh = HashBytes(&lb.addr, sizeof(lb.addr));
+  lh = HashBytes(&lb.bus, sizeof(lb.bus), lh);
+  if (lb.data.size())
+    lh = HashBytes(&lb.data[0], lb.data.size(), lh);
+  PutString(hdr, name);
+  PutU32(hdr, (uint32_t)lb.data.size());
+  PutU32(hdr, lh);
+  h = HashBytes(hdr.data() + hdr.size() - 8, 8, h);
+  }
+parseKey = h;
+return hdr;
+}
+
+/*****************************************************************************/
+/* RestoreSnapshot : writes the output from a snapshot if it's still valid   */
+/*****************************************************************************/
+
+bool Application::RestoreSnapshot()
+{
+string data;
+if (!ReadWholeFile(snapName, data))
+  return false;                         /* not there (yet)                   */
+
+string::size_type pos = 12, tpos = data.size() - 8;
+uint32_t oldKey, stateLen, textLen, hash;
+SnapFiles oldFiles, newFiles;
+if (data.size() < 28 ||
+    data.compare(0, 8, snapHeader, 0, 8) ||
+    !GetSnapFiles(data, pos, oldFiles) ||
+    !GetU32(data, pos, oldKey) ||
+    !GetU32(data, pos, stateLen) ||
+    !GetU32(data, tpos, textLen) ||
+    pos + stateLen + textLen + 8 != data.size() ||
+    !GetU32(data, tpos, hash) ||
+    hash != HashBytes(data.data(), data.size() - 4))
+  {
+  Message(sformat("Snapshot \"%s\" not usable", snapName.c_str()));
+  return false;
+  }
+
+if (data.compare(0, snapHeader.size(), snapHeader))
+  {                                     /* tell what's changed since then    */
+  string::size_type npos = 12;
+  GetSnapFiles(snapHeader, npos, newFiles);
+  if (data.compare(8, 4, snapHeader, 8, 4))
+    Message(sformat("Snapshot \"%s\" outdated: command line changed", snapName.c_str()));
+  for (SnapFiles::const_iterator fi = newFiles.begin();
+       fi != newFiles.end();
+       fi++)
+    {
+    SnapFiles::const_iterator ofi = oldFiles.find(fi->first);
+    if (ofi == oldFiles.end() || ofi->second != fi->second)
+      Message(sformat("Snapshot \"%s\" outdated: \"%s\" changed",
+                      snapName.c_str(), fi->first.c_str()));
+    }
+  for (SnapFiles::const_iterator fi = oldFiles.begin();
+       fi != oldFiles.end();
+       fi++)
+    if (newFiles.find(fi->first) == newFiles.end())
+      Message(sformat("Snapshot \"%s\" outdated: \"%s\" no longer used",
+                      snapName.c_str(), fi->first.c_str()));
+  if (oldKey == parseKey)               /* only comments changed?            */
+    parseState.assign(data, pos, stateLen);
+  return false;
+  }
+
+Message(sformat("Loaded: snapshot \"%s\"", snapName.c_str()));
+if (!out.Open(outname))
+  out.Open();
+out.Write(data.data() + pos + stateLen, textLen);
+out.Close();
+return true;
+}
+
+/*****************************************************************************/
+/* SaveSnapshot : writes the snapshot for the rendered output                */
+/*****************************************************************************/
+
+// The header and the text have already been written through the output's
+// copy; all that's left is the trailer.
+
+bool Application::SaveSnapshot()
+{
+uint32_t textLen, hash;
+bool bOK;
+FILE *fp = out.EndCopy(textLen, hash, bOK);
+if (!fp)
+  return false;
+string trailer;
+PutU32(trailer, textLen);
+hash = HashBytes(trailer.data(), trailer.size(), hash);
+PutU32(trailer, hash);
+bOK &= fwrite(trailer.data(), 1, trailer.size(), fp) == trailer.size();
+bOK &= !fclose(fp);
+if (!bOK)                               /* don't leave a broken one behind   */
+  remove(snapName.c_str());
+return bOK;
+}
+
+/*****************************************************************************/
+/* SaveInfoLabels : stores the labels the info files set up before Parse()   */
+/*****************************************************************************/
+
+// Info labels layout:
+//   for each bus:
+//     uint32 nLabels, then per label:  uint32 addr, memType,
+//                                      uint32 len, text
+//
+// LABEL and USEDLABEL only go into the parse key with their address
+// range, so a later run may have different names for these labels;
+// ApplyParse() uses this list to carry the new names over.
+
+void Application::SaveInfoLabels()
+{
+string &s = infoLabelState;
+s.clear();
+for (int bus = 0; bus < pDasm->GetBusCount(); bus++)
+  {
+  PutU32(s, (uint32_t)pDasm->GetLabelCount(bus));
+  for (int i = 0; i < pDasm->GetLabelCount(bus); i++)
+    {
+    Label *pLabel = pDasm->LabelAt(i, bus);
+    PutU32(s, pLabel->GetAddress());
+    PutU32(s, (uint32_t)pLabel->GetType());
+    PutString(s, pLabel->GetText());
+    }
+  }
+}
+
+/*****************************************************************************/
+/* SaveParse : stores the state after Parse() for the snapshot               */
+/*****************************************************************************/
+
+// Parse state layout (the snapshot's "state" block):
+//   uint32 len, info labels            labels before Parse() (see
+//                                      SaveInfoLabels())
+//   for each bus:
+//     uint32 nCells, then per cell:    attributes, as
+//       (size - 1) | memType << 8 | cellType << 11 | display << 14 | used << 17
+//     uint32 nLabels, then per label:  uint32 addr, memType | used << 8,
+//                                      uint32 len, text
+//     uint32 nDefLabels, then each:    uint32 addr, memType,
+//                                      uint32 len, text, uint32 len, definition
+//   uint32 nIllegal, then per entry:   uint32 addr, bus
+//
+// Everything else Parse() depends on is rebuilt from the (unchanged) data
+// and info files. Break flags come from comments, so they are left alone.
+
+void Application::SaveParse()
+{
+string &s = parseState;
+s.clear();
+PutString(s, infoLabelState);
+for (int bus = 0; bus < pDasm->GetBusCount(); bus++)
+  {
+  uint32_t nCells = 0;
+  for (int i = 0; i < pDasm->GetMemoryArrayCount(bus); i++)
+    nCells += (uint32_t)pDasm->GetMemoryArray(i, bus).size();
+  PutU32(s, nCells);
+  for (int i = 0; i < pDasm->GetMemoryArrayCount(bus); i++)
+    {
+    addr_t start = pDasm->GetMemoryArray(i, bus).GetStart();
+    addr_t end = start + (addr_t)pDasm->GetMemoryArray(i, bus).size();
+    for (addr_t addr = start; addr != end; addr++)
+      PutU32(s, (uint32_t)(pDasm->GetCellSize(addr, bus) - 1) |
+                ((uint32_t)pDasm->GetMemType(addr, bus) << 8) |
+                ((uint32_t)pDasm->GetCellType(addr, bus) << 11) |
+                ((uint32_t)pDasm->GetDisplay(addr, bus) << 14) |
+                ((uint32_t)pDasm->IsCellUsed(addr, bus) << 17));
+    }
+
+  PutU32(s, (uint32_t)pDasm->GetLabelCount(bus));
+  for (int i = 0; i < pDasm->GetLabelCount(bus); i++)
+    {
+    Label *pLabel = pDasm->LabelAt(i, bus);
+    PutU32(s, pLabel->GetAddress());
+    PutU32(s, (uint32_t)pLabel->GetType() | ((uint32_t)pLabel->IsUsed() << 8));
+    PutString(s, pLabel->GetText());
+    }
+
+  PutU32(s, (uint32_t)pDasm->GetDefLabelCount(bus));
+  for (int i = 0; i < pDasm->GetDefLabelCount(bus); i++)
+    {
+    DefLabel *pLabel = pDasm->DefLabelAt(i, bus);
+    PutU32(s, pLabel->GetAddress());
+    PutU32(s, (uint32_t)pLabel->GetType());
+    PutString(s, pLabel->GetText());
+    PutString(s, pLabel->GetDefinition());
+    }
+  }
+
+PutU32(s, (uint32_t)illegalInsts.size());
+for (vector<pair<addr_t, int> >::size_type i = 0; i < illegalInsts.size(); i++)
+  {
+  PutU32(s, illegalInsts[i].first);
+  PutU32(s, (uint32_t)illegalInsts[i].second);
+  }
+}
+
+/*****************************************************************************/
+/* ApplyParse : checks or applies the state after Parse() from the snapshot  */
+/*****************************************************************************/
+
+// Labels set up by the info files keep their current names. A stored
+// label is renamed if it still has the address and name its info label
+// had in the run that wrote the snapshot (Parse() may have given it a
+// type). Since Parse() compares label names when it adds its own labels,
+// a rename from or to any other stored label's name makes the state
+// unusable.
+
+bool Application::ApplyParse(bool bApply)
+{
+const string &s = parseState;
+string::size_type pos = 0, ipos = 0;
+uint32_t n, u, i;
+addr_t addr;
+string txt, def, infoLabels;
+if (!GetString(s, pos, infoLabels))
+  return false;
+for (int bus = 0; bus < pDasm->GetBusCount(); bus++)
+  {
+  // old info label name -> current name, and all names involved
+  map<pair<addr_t, string>, string> renamed;
+  map<string, bool> names;
+  if (!GetU32(infoLabels, ipos, n) ||
+      n != (uint32_t)pDasm->GetLabelCount(bus))
+    return false;
+  for (i = 0; i < n; i++)
+    {
+    Label *pLabel = pDasm->LabelAt((int)i, bus);
+    if (!GetU32(infoLabels, ipos, addr) || !GetU32(infoLabels, ipos, u) ||
+        !GetString(infoLabels, ipos, txt) ||
+        addr != pLabel->GetAddress() || u != (uint32_t)pLabel->GetType())
+      return false;
+    if (txt == pLabel->GetText())
+      continue;
+    renamed[make_pair(addr, txt)] = pLabel->GetText();
+    names[txt] = names[pLabel->GetText()] = true;
+    }
+
+  uint32_t nCells = 0;
+  for (int a = 0; a < pDasm->GetMemoryArrayCount(bus); a++)
+    nCells += (uint32_t)pDasm->GetMemoryArray(a, bus).size();
+  if (!GetU32(s, pos, n) || n != nCells ||
+      pos + 4 * (string::size_type)nCells > s.size())
+    return false;
+  for (int a = 0; a < pDasm->GetMemoryArrayCount(bus); a++)
+    {
+    addr_t start = pDasm->GetMemoryArray(a, bus).GetStart();
+    addr_t end = start + (addr_t)pDasm->GetMemoryArray(a, bus).size();
+    for (addr = start; addr != end; addr++)
+      {
+      GetU32(s, pos, u);
+      if (!bApply)
+        continue;
+      pDasm->SetCellSize(addr, (int)(u & 0xff) + 1, bus);
+      pDasm->SetMemType(addr, (MemoryType)((u >> 8) & 7), bus);
+      pDasm->SetCellType(addr, (MemAttribute::Type)((u >> 11) & 7), bus);
+      pDasm->SetDisplay(addr, (MemAttribute::Display)((u >> 14) & 7), bus);
+      pDasm->SetCellUsed(addr, !!(u & (1 << 17)), bus);
+      }
+    }
+
+  if (!GetU32(s, pos, n))
+    return false;
+  if (bApply)
+    pDasm->ClearLabels(bus);
+  for (i = 0; i < n; i++)
+    {
+    if (!GetU32(s, pos, addr) || !GetU32(s, pos, u) ||
+        !GetString(s, pos, txt))
+      return false;
+    map<pair<addr_t, string>, string>::const_iterator ri =
+        renamed.find(make_pair(addr, txt));
+    if (ri != renamed.end())
+      txt = ri->second;
+    else if (names.find(txt) != names.end())
+      return false;                     /* renamed to / from a Parse() name  */
+    if (bApply)
+      pDasm->AppendLabel(addr, (MemoryType)(u & 0xff), txt, !!(u >> 8), bus);
+    }
+
+  if (!GetU32(s, pos, n))
+    return false;
+  if (bApply)
+    pDasm->ClearDefLabels(bus);
+  for (i = 0; i < n; i++)
+    {
+    if (!GetU32(s, pos, addr) || !GetU32(s, pos, u) ||
+        !GetString(s, pos, txt) || !GetString(s, pos, def))
+      return false;
+    if (bApply)
+      pDasm->AppendDefLabel(addr, (MemoryType)u, txt, def, bus);
+    }
+  }
+
+if (!GetU32(s, pos, n))
+  return false;
+for (i = 0; i < n; i++)
+  {
+  if (!GetU32(s, pos, addr) || !GetU32(s, pos, u))
+    return false;
+  if (bApply)
+    {
+    AddLComment(addr, "Illegal instruction!", false, (int)u);
+    illegalInsts.push_back(make_pair(addr, (int)u));
     }
   }
+return pos == s.size() && ipos == infoLabels.size();
+}
+
+/*****************************************************************************/
+/* RestoreParse : reuses the state after Parse() from the snapshot           */
+/*****************************************************************************/
+
+// The state is checked completely before anything is changed, so that a
+// false return leaves everything ready for a normal Parse().
 
+bool Application::RestoreParse()
+{
+if (parseState.empty() || !ApplyParse(false))
+  {
+  parseState.clear();
+  return false;
+  }
+ApplyParse(true);
+Message(sformat("Reused: parse from snapshot \"%s\"", snapName.c_str()));
 return true;
 }
 
 /*****************************************************************************/
-/* DisassembleDefLabels : disassemble all used DefLabels                     */
+/* RenderListing : renders all collected listing lines to the output         */
 /*****************************************************************************/
 
-bool Application::DisassembleDefLabels
-    (
-    string sComDel,
-    string sComHdr,
-    int bus
-    )
-{
-string sComBlk(sComDel + " ");
+// Called whenever a block of lines is complete, and at the end of the run.
 
-static bool bULHOut = false;
-for (int l = 0; l < pDasm->GetDefLabelCount(bus); l++)
+bool Application::RenderListing()
+{
+string text;
+for (vector<ListingLine>::size_type i = 0;
+     i < listing.size() && !bSinkDone;
+     i++)
   {
-  DefLabel *pLbl = pDasm->DefLabelAt(l, bus);
-  string slabel, smnemo, sparm;
-  // DefLabels got no comments ATM
-  if (pLbl &&
-      pDasm->DisassembleDefLabel(pLbl, slabel, smnemo, sparm, bus))
+  text.clear();
+  if (outFormat == ofJson)
+    RenderJsonLine(listing[i], text);
+  else
+    RenderLine(listing[i], text);
+  if (!pSink)
     {
-    // header, if not yet done
-    if (!bULHOut)
-      {
-      PrintLine();
-      PrintLine(sComHdr);
-      PrintLine(sComBlk + "Used Definitions");
-      PrintLine(sComHdr);
-      PrintLine();
-      bULHOut = true;
-      }
-    // and no line comments
-    PrintLine(slabel, smnemo, sparm, "", lLabelLen);
+    out.Put(text);
+    out.EndLine();
     }
+  else if (!pSink->Line(listing[i], text))
+    bSinkDone = true;                   /* sink doesn't want any more        */
   }
-
+listing.clear();
 return true;
 }
 
 /*****************************************************************************/
-/* DisassembleLine : create a line of disassembler output (+comments)        */
+/* Utf8Len : returns length of a valid UTF-8 sequence at a position, or 0    */
 /*****************************************************************************/
 
-addr_t Application::DisassembleLine
-    (
-    addr_t addr,
-    string sComDel,
-    string sComHdr,
-    string labelDelim,
-    int bus
-    )
+static string::size_type Utf8Len(const string &txt, string::size_type i)
 {
-string sLabel, sMnemo, sParms, sComBlk(sComDel + " ");
-CommentArray::iterator it;
-Comment *pComment;
-bool bWithComments = showHex || showAsc || showAddr;
-
-// comments before line
-DisassembleComments(addr, false, sComDel, bus);
-
-// the line itself
-// in case of multiple labels, it's always the last one that's used
-// for the "real" code/data line, so prepend all others
-LabelArray::iterator lit;
-Label *p = NULL, *pNext = pDasm->GetFirstLabel(addr, lit, Untyped, bus);
-while (pNext)
+uint8_t c = (uint8_t)txt[i];
+string::size_type n;
+uint8_t lo = 0x80, hi = 0xbf;           /* valid range for the 2nd byte      */
+if (c >= 0xc2 && c <= 0xdf)
+  n = 2;
+else if (c >= 0xe0 && c <= 0xef)
   {
-  if (pNext->IsUsed() && !pNext->IsConst())
-    p = pNext;
-  pNext = pDasm->GetNextLabel(addr, lit, Untyped, bus);
-  // multiple labels get their own lines
-  if (p != pNext && pNext && pNext->IsUsed() && !pNext->IsConst())
-    {
-    string s = p->GetText();
-    if (s.size())
-      PrintLine(s + labelDelim);
-    }
+  n = 3;
+  if (c == 0xe0) lo = 0xa0;             /* no overlong forms                 */
+  if (c == 0xed) hi = 0x9f;             /* no UTF-16 surrogates              */
   }
-if (p && p->IsUsed() && !p->IsConst())
-  sLabel = pDasm->Label2String(addr, 4, true, addr, bus) +
-           labelDelim;
-pComment = showComments ? GetFirstLComment(addr, it, bus) : NULL;
-int maxparmlen = (bWithComments || pComment) ? (cparmLen - 1) : uparmLen;
-addr_t sz = pDasm->Disassemble(addr, sMnemo, sParms, maxparmlen, bus);
+else if (c >= 0xf0 && c <= 0xf4)
+  {
+  n = 4;
+  if (c == 0xf0) lo = 0x90;             /* no overlong forms                 */
+  if (c == 0xf4) hi = 0x8f;             /* nothing above U+10FFFF            */
+  }
+else
+  return 0;
+if (i + n > txt.size())
+  return 0;
+for (string::size_type j = 1; j < n; j++)
+  {
+  uint8_t cc = (uint8_t)txt[i + j];
+  if (cc < lo || cc > hi)
+    return 0;
+  lo = 0x80;
+  hi = 0xbf;
+  }
+return n;
+}
 
-string scomment;
-if (showAddr)
-  scomment += sformat("%0*X%s",
-                      (pDasm->BusAddressBits(bus) + 3) / 4, addr,
-                      (showHex || showAsc) ? ": " : " ");
-if ((showHex || showAsc) && !pDasm->IsBss(addr, bus))
+/*****************************************************************************/
+/* AppendJson : appends a quoted and escaped JSON string                     */
+/*****************************************************************************/
+
+static string &AppendJson(string &s, const string &txt)
+{
+s += '"';
+for (string::size_type i = 0; i < txt.size(); i++)
   {
-  string sHex, sAsc;
-  if (showHex || showAsc)
+  uint8_t c = (uint8_t)txt[i];
+  if (c == '"' || c == '\\')
     {
-    pDasm->DisassembleHexAsc(addr, sz, (addr_t)dbCount, sHex, sAsc, bus);
-    if (!pComment)
-      sAsc = trim(sAsc);
-#if 0
-    for (addr_t i = sz; i < (addr_t)dbCount; i++)
+    s += '\\';
+    s += (char)c;
+    }
+  else if (c < 0x20 || c == 0x7f)       /* control characters                */
+    AppendHex(s += "\\u", c, 4, false);
+  else if (c < 0x80)
+    s += (char)c;
+  else                                  /* valid UTF-8 is passed through,    */
+    {                                   /* anything else is taken as Latin-1 */
+    string::size_type n = Utf8Len(txt, i);
+    if (n)
       {
-      if (showHex && showAsc)
-        sHex += "   ";
-      if (showAsc && pComment)
-        sAsc += ' ';
+      s.append(txt, i, n);
+      i += n - 1;
       }
-#endif
+    else
+      AppendHex(s += "\\u", c, 4, false);
     }
+  }
+s += '"';
+return s;
+}
 
-  if (showHex)
-    scomment += sHex;
-  if (showAsc)
-    scomment += sAsc;
+/*****************************************************************************/
+/* RenderJsonLine : renders a listing line as a JSON record to a string     */
+/*****************************************************************************/
+
+bool Application::RenderJsonLine(const ListingLine &line, string &s)
+{
+static const char *kinds[] =
+  {
+  "text", "comment", "insert", "change", "label",
+  "deflabel", "code", "data", "lcomment"
+  };
+s += "{\"kind\":\"";
+s += kinds[line.kind];
+s += "\",\"bus\":";
+AppendJson(s, lowercase(pDasm->GetBusName(line.bus)));
+if (line.addr != NO_ADDRESS)
+  {
+  AppendDec(s += ",\"addr\":", line.addr);
+  AppendDec(s += ",\"size\":", line.size);
   }
-if (pComment && pComment->GetText().size())
+if (line.size && !pDasm->IsBss(line.addr, line.bus))
   {
-  if (scomment.size()) scomment += " ";
-  scomment += pComment->GetText();
+  s += ",\"bytes\":\"";
+  for (addr_t i = 0; i < line.size; i++)
+    AppendHex(s, pDasm->GetUByte(line.addr + i, line.bus), 2);
+  s += '"';
   }
-if (scomment.size()) scomment = sComBlk + scomment;
-PrintLine(sLabel, sMnemo, sParms, scomment);
-if (pComment)
+switch (line.kind)
   {
-// following line comments
-  while ((pComment = GetNextLComment(addr, it, bus)) != NULL)
-    PrintLine("", "", "", sComBlk + pComment->GetText());
+  case ListingLine::lkText :
+  case ListingLine::lkComment :
+  case ListingLine::lkInsert :
+    AppendJson(s += ",\"text\":", line.sLabel);
+    break;
+  default :
+    if (line.sLabel.size())
+      AppendJson(s += ",\"label\":", line.sLabel);
+    if (line.smnemo.size())
+      AppendJson(s += ",\"mnemo\":", line.smnemo);
+    if (line.sparm.size())
+      AppendJson(s += ",\"parms\":", line.sparm);
+    break;
   }
-
-// comments after line
-DisassembleComments(addr, true, sComDel, bus);
-
-return sz;
+if (line.slcomment.size())
+  AppendJson(s += ",\"comment\":", line.slcomment);
+s += '}';
+return true;
 }
 
 /*****************************************************************************/
-/* PrintLine : prints a formatted line to the output                         */
+/* RenderLine : renders a listing line as formatted text to a string         */
 /*****************************************************************************/
 
-bool Application::PrintLine
-    (
-    string sLabel,
-    string smnemo,
-    string sparm,
-    string scomment,
-    int labelLen
-    )
+// The text is appended to the string without a trailing newline.
+
+bool Application::RenderLine(const ListingLine &line, string &s)
 {
-if (labelLen < 0) labelLen = this->labelLen;
+const string &sLabel = line.sLabel;
+const string &smnemo = line.smnemo;
+const string &sparm = line.sparm;
+const string &scomment = line.scomment;
+int labelLen = (line.labelLen < 0) ? this->labelLen : line.labelLen;
 int nLen = 0;
 int nMinLen = labelLen;
-bool bLastBlank = false;
 if (sLabel.size())
   {
-  nLen += fprintf(out, "%s", sLabel.c_str());
+  s += sLabel;
+  nLen += sLabel.size();
   if (nLen > labelLen &&  // skip to next line on very long labels
       smnemo.size())
-    nLen = fprintf(out, "\n%*s", labelLen - 1, "") - 1;
+    {
+    s += '\n';
+    nLen = abs(labelLen - 1);
+    s.append(nLen, ' ');
+    }
   }
 
 if (smnemo.size())
   {
-  if (nLen > 0) nLen += fprintf(out, " ");
-  if (nLen < nMinLen) nLen += fprintf(out, "%*s", nMinLen - nLen, "");
-  nLen += fprintf(out, "%s", smnemo.c_str());
+  if (nLen > 0) { s += ' '; nLen++; }
+  if (nLen < nMinLen) { s.append(nMinLen - nLen, ' '); nLen = nMinLen; }
+  s += smnemo;
+  nLen += smnemo.size();
   }
 nMinLen += mnemoLen;
 if (sparm.size())
   {
-  if (nLen > 0) nLen += fprintf(out, " ");
-  if (nLen < nMinLen) nLen += fprintf(out, "%*s", nMinLen - nLen, "");
-  nLen += fprintf(out, "%s", sparm.c_str());
+  if (nLen > 0) { s += ' '; nLen++; }
+  if (nLen < nMinLen) { s.append(nMinLen - nLen, ' '); nLen = nMinLen; }
+  s += sparm;
+  nLen += sparm.size();
   }
 nMinLen += cparmLen;
 if (scomment.size())
   {
-  if (nLen > 0) nLen += fprintf(out, " ");
-  if (nLen < nMinLen) nLen += fprintf(out, "%*s", nMinLen - nLen, "");
-  nLen += fprintf(out, "%s", scomment.c_str());
+  if (nLen > 0) { s += ' '; nLen++; }
+  if (nLen < nMinLen) { s.append(nMinLen - nLen, ' '); nLen = nMinLen; }
+  s += scomment;
+  nLen += scomment.size();
   }
-nLen += fprintf(out, "\n");
-return nLen > 0;
+return true;
 }
 
 /*****************************************************************************/
 /* ParseInfoRange : parses a range definition from an info file              */
 /*****************************************************************************/
 
-int Application::ParseInfoRange(string value, addr_t &from, addr_t &to)
+// pPre, if given, holds the value's range as pre-resolved by the info cache.
+
+int Application::ParseInfoRange(string value, addr_t &from, addr_t &to, const InfoLine *pPre)
 {
-int n = pDasm ? pDasm->String2Range(value, from, to) : 0;
+int n;
+if (pPre)
+  {
+  n = pPre->nRange;
+  from = pPre->from;
+  to = pPre->to;
+  }
+else
+  n = pDasm ? pDasm->String2Range(value, from, to) : 0;
 if (n < 1)
   from = NO_ADDRESS;
 if (from != NO_ADDRESS)
@@ -952,35 +2562,278 @@ return sout.substr(0, sout.find_last_not_of(" ") + 1);
 }
 
 /*****************************************************************************/
-/* LoadInfo : loads an information file                                      */
+/* InfoFileName : extracts a (quoted) file name from an info line's value    */
 /*****************************************************************************/
 
-bool Application::LoadInfo
-    (
-    string fileName,
-    vector<string> &loadStack,
-    bool bProcInfo,
-    bool bSetDasm
-    )
+string Application::InfoFileName(const string &value, string::size_type *pNext)
 {
-if (!pDasm && bProcInfo)                /* no disassembler, no work.         */
-  return false;
-                                        /* inhibit recursion                 */
-for (vector<string>::const_iterator lsi = loadStack.begin();
-     lsi != loadStack.end();
-     lsi++)
-  if (*lsi == fileName)
+char delim1 = ' ', delim2 = '\t';
+string fn;
+string::size_type i = 0;
+if (i < value.size() && (value[i] == '\"' || value[i] == '\''))
+  {
+  delim1 = value[i++];
+  delim2 = '\0';
+  }
+for (; i < value.size() && value[i] != delim1 && value[i] != delim2; i++)
+  fn += value[i];
+if (pNext)                              /* skip the delimiter, if any        */
+  *pNext = (i < value.size()) ? i + 1 : i;
+return fn;
+}
+
+/*****************************************************************************/
+/* SplitInfo : splits an information file's text into key/value lines        */
+/*****************************************************************************/
+
+void Application::SplitInfo(const string &text, vector<InfoLine> &lines)
+{
+string line;
+string::size_type pos = 0, eol;
+while (pos < text.size())
+  {
+  // skip leading whitespace and f9dasm '+' (not needed in dasmfw)
+  while (pos < text.size() &&
+         (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '+'))
+    pos++;
+  eol = text.find_first_of("\r\n", pos);
+  if (eol == text.npos)
+    eol = text.size();
+  line.assign(text, pos, eol - pos);
+  pos = eol + 1;
+
+  if (line.size() &&                    /* if line has contents              */
+      line[0] != '*' && line[0] != ';')
+    {
+    string::size_type idx = line.find_first_of(" \t");
+    if (idx == line.npos) idx = line.size();
+    lines.push_back(InfoLine());
+    lines.back().key = uppercase(line.substr(0, idx));
+    lines.back().value = trim(line.substr(idx));
+    }
+  }
+}
+
+/*****************************************************************************/
+/* CompileInfo : reads an information file into its key/value lines          */
+/*****************************************************************************/
+
+// Info files are processed twice (once for includes and files, once for
+// the real work) and may be included several times, so each one is read
+// and split into key/value pairs only once per run.
+
+const vector<Application::InfoLine> *Application::CompileInfo(string fileName)
+{
+InfoCache::const_iterator ci = infoCache.find(fileName);
+if (ci != infoCache.end())
+  return &ci->second;
+
+string text;
+map<string, string>::const_iterator ti = infoTexts.find(fileName);
+if (ti != infoTexts.end())              /* in-memory info text               */
+  text = ti->second;
+else
+  {
+  if (pSharedInfo &&                    /* already compiled for all jobs?    */
+      (ci = pSharedInfo->find(fileName)) != pSharedInfo->end())
+    return &ci->second;
+
+                                        /* that's definitely a text file     */
+  FILE *fp = fopen(fileName.c_str(), "r");
+  if (!fp)
+    return NULL;
+  char chunk[16384];                    /* read it in one go                 */
+  size_t nRead;
+  while ((nRead = fread(chunk, 1, sizeof(chunk), fp)) > 0)
+    text.append(chunk, nRead);
+  fclose(fp);
+
+  struct stat st;                       /* compiled in an earlier run?       */
+  if (infoCacheDir.size() && !stat(fileName.c_str(), &st))
+    {
+    InfoFileState state;
+    state.mtime = (uint32_t)st.st_mtime;
+    state.size = (uint32_t)st.st_size;
+    state.hash = HashBytes(text.data(), text.size());
+    if (ReadInfoCache(fileName, state))
+      return &infoCache[fileName];
+    infoToCache[fileName] = state;
+    }
+  }
+
+vector<InfoLine> &lines = infoCache[fileName];
+SplitInfo(text, lines);
+return &lines;
+}
+
+/*****************************************************************************/
+/* Info cache : compiled info files that are kept between runs               */
+/*****************************************************************************/
+
+// Info cache file layout (all numbers little-endian):
+//   char[8] "DFWINFC2"                 magic
+//   uint32 len, char[len]              full path of the info file
+//   uint32 mtime, size, textHash       info file state when compiled
+//   uint32 len, char[len]              range key (see InfoRangeKey())
+//   uint32 nLines                      number of lines, then for each:
+//     uint32 len, char[len]            keyword
+//     uint32 len, char[len]            value
+//     uint32 nRange, from, to          String2Range() result for the value
+//   uint32 hash                        FNV-1a over all of the above
+//
+// An entry is only used if the text hash matches, too, so that an edit
+// within the same second that keeps the size is not missed.
+// Ranges are resolved with the disassembler and number base in effect
+// when the file is written; LoadInfo() only uses them while these match.
+
+static const char infoCacheMagic[] = "DFWINFC2";
+
+static string FullPath(const string &fileName)
+{
+string full(fileName);
+#ifdef _MSC_VER
+char *p = _fullpath(NULL, fileName.c_str(), 0);
+#else
+char *p = realpath(fileName.c_str(), NULL);
+#endif
+if (p)
+  {
+  full = p;
+  free(p);
+  }
+return full;
+}
+
+/*****************************************************************************/
+/* InfoRangeKey : returns what String2Range() currently depends on           */
+/*****************************************************************************/
+
+string Application::InfoRangeKey()
+{
+return pDasm ? pDasm->GetName() + " " + pDasm->GetOption("pbase") : "";
+}
+
+/*****************************************************************************/
+/* InfoCacheName : returns the info cache file name for an info file         */
+/*****************************************************************************/
+
+string Application::InfoCacheName(const string &fileName)
+{
+string full(FullPath(fileName));
+return infoCacheDir + "/" +
+       sformat("%08x.nfc", HashBytes(full.data(), full.size()));
+}
+
+/*****************************************************************************/
+/* ReadInfoCache : loads a compiled info file if it's still up to date       */
+/*****************************************************************************/
+
+bool Application::ReadInfoCache(string fileName, const InfoFileState &state)
+{
+string data;
+string::size_type pos = 8;
+uint32_t hash, cmtime, csize, chash, nLines, nRange, from, to;
+string name, rangeKey;
+if (!ReadWholeFile(InfoCacheName(fileName), data) ||
+    data.size() < 12 ||
+    data.compare(0, 8, infoCacheMagic, 8) ||
+    !GetString(data, pos, name) || name != FullPath(fileName) ||
+    !GetU32(data, pos, cmtime) || cmtime != state.mtime ||
+    !GetU32(data, pos, csize) || csize != state.size ||
+    !GetU32(data, pos, chash) || chash != state.hash)
+  return false;                         /* missing or outdated               */
+
+string::size_type hpos = data.size() - 4;
+if (!GetU32(data, hpos, hash) ||
+    hash != HashBytes(data.data(), data.size() - 4) ||
+    !GetString(data, pos, rangeKey) ||
+    !GetU32(data, pos, nLines))
+  return false;                         /* damaged                           */
+
+vector<InfoLine> lines;
+for (uint32_t i = 0; i < nLines; i++)
+  {
+  lines.push_back(InfoLine());
+  InfoLine &line = lines.back();
+  if (!GetString(data, pos, line.key) ||
+      !GetString(data, pos, line.value) ||
+      !GetU32(data, pos, nRange) ||
+      !GetU32(data, pos, from) ||
+      !GetU32(data, pos, to))
     return false;
+  line.nRange = (int)nRange;
+  line.from = from;
+  line.to = to;
+  }
+infoCache[fileName].swap(lines);
+infoRangeKeys[fileName] = rangeKey;
+return true;
+}
+
+/*****************************************************************************/
+/* WriteInfoCache : saves the info files compiled in this run                */
+/*****************************************************************************/
+
+// Called once the info files are processed, so that the disassembler and
+// its number base are the ones the ranges are going to be used with.
+
+bool Application::WriteInfoCache()
+{
+bool bOK = true;
+string rangeKey(InfoRangeKey());
+for (map<string, InfoFileState>::const_iterator ci = infoToCache.begin();
+     ci != infoToCache.end();
+     ci++)
+  {
+  vector<InfoLine> &lines = infoCache[ci->first];
+  string data(infoCacheMagic, 8);
+  PutString(data, FullPath(ci->first));
+  PutU32(data, ci->second.mtime);
+  PutU32(data, ci->second.size);
+  PutU32(data, ci->second.hash);
+  PutString(data, rangeKey);
+  PutU32(data, (uint32_t)lines.size());
+  for (vector<InfoLine>::size_type i = 0; i < lines.size(); i++)
+    {
+    InfoLine &line = lines[i];
+    line.nRange = pDasm->String2Range(line.value, line.from, line.to);
+    PutString(data, line.key);
+    PutString(data, line.value);
+    PutU32(data, (uint32_t)line.nRange);
+    PutU32(data, line.from);
+    PutU32(data, line.to);
+    }
+  PutU32(data, HashBytes(data.data(), data.size()));
 
-if (bProcInfo)                          /* if in processing mode             */
-  {                                     /* assure this is only done once     */
-  for (vector<string>::const_iterator lsi = saPINames.begin();
-       lsi != saPINames.end();
-       lsi++)
-     if (*lsi == fileName)
-       return false;
-  saPINames.push_back(fileName);
+  // written under a temporary name, so that a concurrent reader never
+  // sees a half-written file; process id and instance keep the names of
+  // concurrent writers apart
+  string cacheName(InfoCacheName(ci->first));
+#ifdef _MSC_VER
+  unsigned long pid = (unsigned long)_getpid();
+#else
+  unsigned long pid = (unsigned long)getpid();
+#endif
+  string tmpName(cacheName + sformat(".%lu.%p", pid, (void *)this));
+  FILE *fp = fopen(tmpName.c_str(), "wb");
+  bool bWritten = fp &&
+                  fwrite(data.data(), 1, data.size(), fp) == data.size();
+  if (fp)
+    bWritten &= !fclose(fp);
+  remove(cacheName.c_str());
+  if (!bWritten || rename(tmpName.c_str(), cacheName.c_str()))
+    {
+    remove(tmpName.c_str());
+    bOK = false;
+    }
   }
+infoToCache.clear();
+return bOK;
+}
+
+/*****************************************************************************/
+/* Info file keywords : keyword to info command translation                  */
+/*****************************************************************************/
 
 enum InfoCmd
   {
@@ -1048,11 +2901,7 @@ enum InfoCmd
   // end info file processing
   infoEnd,                              /* END (processing this file)        */
   };
-static struct                           /* structure to convert key to type  */
-  {
-  const char *name;
-  InfoCmd cmdType;
-  } sKey[] =
+static const KeywordTable::Keyword sKey[] =
   {
   // bus selection
   { "BUS",          infoBusSel },
@@ -1136,691 +2985,689 @@ static struct                           /* structure to convert key to type  */
   // end info file processing
   { "END",          infoEnd },
   };
+static KeywordTable infoKeys(sKey, _countof(sKey));
+
+/*****************************************************************************/
+/* InfoParseHash : hashes the parts of an info file that Parse() depends on  */
+/*****************************************************************************/
 
-                                        /* that's definitely a text file     */
-FILE *fp = fopen(fileName.c_str(), "r");
-if (!fp)
-  return false;
+// Comment directives only add or remove listing text, so they are left out.
+// Of LABEL and USEDLABEL, only the range and the kind of name count; the
+// names themselves are carried over by ApplyParse().
 
-int fc;
-string line;
-bool bMod = false, bEnd = false;
-do
+uint32_t Application::InfoParseHash(string fileName, uint32_t h)
+{
+h = HashBytes(fileName.data(), fileName.size() + 1, h);
+const vector<InfoLine> *pLines = CompileInfo(fileName);
+if (!pLines)
+  return HashBytes("", 1, h);           /* missing file                      */
+for (vector<InfoLine>::size_type ln = 0; ln < pLines->size(); ln++)
   {
-  fc = fgetc(fp);
-  // skip leading whitespace
-  if ((fc == ' ' || fc == '\t') && !line.size())
+  const InfoLine &line = (*pLines)[ln];
+  int cmdType = infoKeys.Find(line.key, infoUnknown);
+  if (cmdType >= infoComment && cmdType <= infoUnLComment)
     continue;
-  if (fc == '+' && !line.size())        /* f9dasm compatibility              */
-    {                                   /* (not needed in dasmfw)            */
-    bMod = true;
-    continue;
-    }
-  if (fc != '\r' && fc != '\n' && fc != EOF)
+  h = HashBytes(line.key.data(), line.key.size() + 1, h);
+  if (cmdType == infoLabel || cmdType == infoUsedLabel)
     {
-    line += (char)fc;
+    string::size_type idx = line.value.find_first_of(" \t");
+    if (idx == line.value.npos) idx = line.value.size();
+    string range(line.value.substr(0, idx));
+    string name((idx < line.value.size()) ?
+                triminfo(line.value.substr(idx), true, false) : "");
+    idx = name.find_first_of(" \t");
+    if (idx != name.npos)
+      name = trim(name.substr(0, idx));
+    char kind = name.empty() ? '0' :    /* none, a name, or a reference      */
+                (name.find_first_of("+-") == name.npos) ? '1' : '2';
+    h = HashBytes(range.data(), range.size() + 1, h);
+    h = HashBytes(&kind, 1, h);
     continue;
     }
-  // newline or end of file encountered
-  if (line.size() &&                    /* if line has contents              */
-      line[0] != '*' && line[0] != ';')
-    {
-    string key, value;
-    string::size_type idx = line.find_first_of(" \t");
-    if (idx == line.npos) idx = line.size();
-    key = uppercase(line.substr(0, idx));
-    value = trim(line.substr(idx));
+  h = HashBytes(line.value.data(), line.value.size() + 1, h);
+  }
+return h;
+}
 
-    InfoCmd cmdType = infoUnknown;
-    for (int i = 0; i < _countof(sKey); i++)
-      if (key == sKey[i].name)
-        {
-        cmdType = sKey[i].cmdType;
-        break;
-        }
+/*****************************************************************************/
+/* LoadInfo : loads an information file                                      */
+/*****************************************************************************/
+
+bool Application::LoadInfo
+    (
+    string fileName,
+    vector<string> &loadStack,
+    bool bProcInfo,
+    bool bSetDasm
+    )
+{
+if (!pDasm && bProcInfo)                /* no disassembler, no work.         */
+  return false;
+                                        /* inhibit recursion                 */
+for (vector<string>::const_iterator lsi = loadStack.begin();
+     lsi != loadStack.end();
+     lsi++)
+  if (*lsi == fileName)
+    return false;
+
+                                        /* phase bit for include registry    */
+int phase = bProcInfo ? 4 : bSetDasm ? 1 : 2;
+int &loaded = infoLoaded[fileName];
+if ((loaded & phase) &&                 /* if already done in this phase     */
+    (bProcInfo || incOnce))             /* (processing is always done once)  */
+  return !bProcInfo;                    /* only processing reports failure   */
+loaded |= phase;
 
-    int tgtBus = infoBus;               /* target bus identification         */
-    idx = value.find_first_of(" \t");
-    if (idx != value.npos &&
-        lowercase(value.substr(0, idx)) == "bus")
+
+const vector<InfoLine> *pLines = CompileInfo(fileName);
+if (!pLines)
+  return false;
+                                        /* pre-resolved ranges still valid?  */
+map<string, string>::const_iterator rki = infoRangeKeys.find(fileName);
+bool bPreOK = rki != infoRangeKeys.end() && rki->second == InfoRangeKey();
+
+bool bEnd = false;
+for (vector<InfoLine>::size_type ln = 0;
+     ln < pLines->size() && !bEnd;
+     ln++)
+  {
+  const InfoLine &line = (*pLines)[ln];
+  string key(line.key), value(line.value);
+  string::size_type idx;
+  const InfoLine *pPre = (bPreOK && line.nRange >= 0) ? &line : NULL;
+
+  InfoCmd cmdType = (InfoCmd)infoKeys.Find(key, infoUnknown);
+
+  int tgtBus = infoBus;                 /* target bus identification         */
+  idx = value.find_first_of(" \t");
+  if (idx != value.npos &&
+      lowercase(value.substr(0, idx)) == "bus")
+    {
+    string bval(trim(value.substr(idx)));
+    idx = bval.find_first_of(" \t");
+    if (idx != bval.npos)
       {
-      string bval(trim(value.substr(idx)));
-      idx = bval.find_first_of(" \t");
-      if (idx != bval.npos)
+      string tgtbus = lowercase(bval.substr(0, idx));
+      bval = trim(bval.substr(idx));
+      int bus = pDasm ? pDasm->GetBusID(tgtbus) : -1;
+      if (bus >= 0)
         {
-        string tgtbus = lowercase(bval.substr(0, idx));
-        bval = trim(bval.substr(idx));
-        int bus = pDasm ? pDasm->GetBusID(tgtbus) : -1;
-        if (bus >= 0)
-          {
-          tgtBus = (int)bus;
-          value = bval;
-          }
+        tgtBus = (int)bus;
+        value = bval;
+        pPre = NULL;                    /* range isn't the value any more    */
         }
       }
+    }
+
+  if (pDasm && !bSetDasm)               /* let disassembler have a go at it  */
+    {
+    addr_t from, to;                    /* address range has to be first!    */
+    ParseInfoRange(value, from, to, pPre);
+    if (pDasm->ProcessInfo(key, value,
+                           from, to,
+                           remaps, bProcInfo,
+                           infoBus, tgtBus))
+      cmdType = infoUnknown;
+    }
+
+  if (!bProcInfo)                       /* if just loading includes and files*/
+    {
+    if (cmdType != infoInclude &&
+        cmdType != infoOption &&
+        cmdType != infoFile)
+      cmdType = infoUnknown;            /* ignore all unwanted command types */
+    if (cmdType == infoFile && bSetDasm)
+      cmdType = infoUnknown;
+    }
+  else                                  /* if processing complete file       */
+    {
+    if (cmdType == infoFile)
+      cmdType = infoUnknown;            /* ignore all unwanted command types */
+    }
 
-    if (pDasm && !bSetDasm)             /* let disassembler have a go at it  */
+  switch (cmdType)
+    {
+    case infoBusSel :                   /* BUS {code|data}                   */
       {
-      addr_t from, to;                  /* address range has to be first!    */
-      ParseInfoRange(value, from, to);
-      if (pDasm->ProcessInfo(key, value,
-                             from, to,
-                             remaps, bProcInfo,
-                             infoBus, tgtBus))
-        cmdType = infoUnknown;
+      int bus = pDasm ? pDasm->GetBusID(value) : -1;
+      if (bus >= 0)
+        infoBus = (int)bus;
       }
-
-    if (!bProcInfo)                     /* if just loading includes and files*/
+      break;
+    case infoInclude :                  /* INCLUDE filename                  */
       {
-      if (cmdType != infoInclude &&
-          cmdType != infoOption &&
-          cmdType != infoFile)
-        cmdType = infoUnknown;          /* ignore all unwanted command types */
-      if (cmdType == infoFile && bSetDasm)
-        cmdType = infoUnknown;
+      string fn(InfoFileName(value));
+      loadStack.push_back(fileName);
+      LoadInfo(fn, loadStack, bProcInfo, bSetDasm);
+      loadStack.pop_back();
       }
-    else                                /* if processing complete file       */
+      break;
+    case infoFile :                     /* FILE filename [offset]            */
       {
-      if (cmdType == infoFile)
-        cmdType = infoUnknown;          /* ignore all unwanted command types */
+      string::size_type next;
+      string fn(InfoFileName(value, &next));
+      value = trim(value.substr(next));
+      addr_t offs, ign;
+      ParseInfoRange(value, offs, ign);
+      if (offs != NO_ADDRESS)
+        saFNames.push_back(sformat("-offset:0x%x", offs));
+      saFNames.push_back(fn);
       }
-
-    switch (cmdType)
+      break;
+    case infoOption :                   /* OPTION name value                 */
       {
-      case infoBusSel :                 /* BUS {code|data}                   */
-        {
-        int bus = pDasm ? pDasm->GetBusID(value) : -1;
-        if (bus >= 0)
-          infoBus = (int)bus;
-        }
-        break;
-      case infoInclude :                /* INCLUDE filename                  */
-        {
-        char delim1 = ' ', delim2 = '\t';
-        string fn;
-        string::size_type i = 0;
-        if (value[i] == '\"' || value[i] == '\'')
-          {
-          delim1 = value[i++];
-          delim2 = '\0';
-          }
-        for (; i < value.size() && value[i] != delim1 && value[i] != delim2; i++)
-          fn += value[i];
-        loadStack.push_back(fileName);
-        LoadInfo(fn, loadStack, bProcInfo, bSetDasm);
-        loadStack.pop_back();
-        }
-        break;
-      case infoFile :                   /* FILE filename [offset]            */
-        {
-        char delim1 = ' ', delim2 = '\t';
-        string fn;
-        string::size_type i = 0;
-        if (value[i] == '\"' || value[i] == '\'')
-          {
-          delim1 = value[i++];
-          delim2 = '\0';
-          }
-        for (; i < value.size() && value[i] != delim1 && value[i] != delim2; i++)
-          fn += value[i];
-        if (i < value.size())
-          value = trim(value.substr(i + 1));
-        else
-          value.clear();
-        addr_t offs, ign;
-        ParseInfoRange(value, offs, ign);
-        if (offs != NO_ADDRESS)
-          saFNames.push_back(sformat("-offset:0x%x", offs));
-        saFNames.push_back(fn);
-        }
-        break;
-      case infoOption :                 /* OPTION name value                 */
-        {
-        string option;
-        idx = value.find_first_of(" \t");
-        if (idx == value.npos) idx = value.size();
-        option = value.substr(0, idx);
-        value = trim(value.substr(idx));
-        ParseOption(option, value, !bProcInfo);
-        }
-        break;
-      case infoRemap :                  /* REMAP addr[-addr] offset          */
+      string option;
+      idx = value.find_first_of(" \t");
+      if (idx == value.npos) idx = value.size();
+      option = value.substr(0, idx);
+      value = trim(value.substr(idx));
+      ParseOption(option, value, !bProcInfo);
+      bPreOK = rki != infoRangeKeys.end() && rki->second == InfoRangeKey();
+      }
+      break;
+    case infoRemap :                    /* REMAP addr[-addr] offset          */
+      {
+      string range;
+      idx = value.find_first_of(" \t");
+      if (idx == value.npos) idx = value.size();
+      range = value.substr(0, idx);
+      value = trim(value.substr(idx));
+      addr_t from, to, off;
+      // allow remapped remaps :-)
+      if (ParseInfoRange(range, from, to) >= 1 &&
+          pDasm->String2Number(value, off))
         {
-        string range;
-        idx = value.find_first_of(" \t");
-        if (idx == value.npos) idx = value.size();
-        range = value.substr(0, idx);
-        value = trim(value.substr(idx));
-        addr_t from, to, off;
-        // allow remapped remaps :-)
-        if (ParseInfoRange(range, from, to) >= 1 &&
-            pDasm->String2Number(value, off))
-          {
-          remaps[infoBus].AddMemory(from, to + 1 - from);
-          for (addr_t scanned = from;
-               scanned >= from && scanned <= to;
-               scanned++)
-            *remaps[infoBus].getat(scanned) += off;
-          }
+        remaps[infoBus].AddMemory(from, to + 1 - from);
+        for (addr_t scanned = from;
+             scanned >= from && scanned <= to;
+             scanned++)
+          *remaps[infoBus].getat(scanned) += off;
         }
-        break;
-      // memory types
-      case infoCode :                   /* CODE addr[-addr]                  */
-      case infoData :                   /* DATA addr[-addr]                  */
-      case infoConstant :               /* CONST addr[-addr]                 */
-      case infoCVector :                /* CVEC[TOR] addr[-addr]             */
-      case infoDVector :                /* DVEC[TOR] addr[-addr]             */
-      case infoRMB :                    /* RMB addr[-addr]                   */
-      case infoUnused :                 /* UNUSED addr[-addr]                */
-      // cell sizes
-      case infoByte :                   /* BYTE addr[-addr]                  */
-      case infoWord :                   /* WORD addr[-addr]                  */
-      case infoDWord :                  /* DWORD addr[-addr]                 */
-      // cell display types
-      case infoBinary :                 /* BINARY addr[-addr]                */
-      case infoChar :                   /* CHAR addr[-addr]                  */
-      case infoOct :                    /* OCT addr[-addr]                   */
-      case infoDec :                    /* DEC addr[-addr]                   */
-      case infoHex :                    /* HEX addr[-addr]                   */
-      // cell types
-      case infoSigned :                 /* SIGNED addr[-addr]                */
-      case infoUnsigned :               /* UNSIGNED addr[-addr]              */
-      // combined size + type
-      case infoFloat :                  /* FLOAT addr[-addr]                 */
-      case infoDouble :                 /* DOUBLE addr[-addr]                */
-      case infoTenBytes :               /* TENBYTES addr[-addr]              */
-      // break before
-      case infoBreak :                  /* BREAK addr[-addr]                 */
-      case infoUnBreak:                 /* UNBREAK addr[-addr]               */
+      }
+      break;
+    // memory types
+    case infoCode :                     /* CODE addr[-addr]                  */
+    case infoData :                     /* DATA addr[-addr]                  */
+    case infoConstant :                 /* CONST addr[-addr]                 */
+    case infoCVector :                  /* CVEC[TOR] addr[-addr]             */
+    case infoDVector :                  /* DVEC[TOR] addr[-addr]             */
+    case infoRMB :                      /* RMB addr[-addr]                   */
+    case infoUnused :                   /* UNUSED addr[-addr]                */
+    // cell sizes
+    case infoByte :                     /* BYTE addr[-addr]                  */
+    case infoWord :                     /* WORD addr[-addr]                  */
+    case infoDWord :                    /* DWORD addr[-addr]                 */
+    // cell display types
+    case infoBinary :                   /* BINARY addr[-addr]                */
+    case infoChar :                     /* CHAR addr[-addr]                  */
+    case infoOct :                      /* OCT addr[-addr]                   */
+    case infoDec :                      /* DEC addr[-addr]                   */
+    case infoHex :                      /* HEX addr[-addr]                   */
+    // cell types
+    case infoSigned :                   /* SIGNED addr[-addr]                */
+    case infoUnsigned :                 /* UNSIGNED addr[-addr]              */
+    // combined size + type
+    case infoFloat :                    /* FLOAT addr[-addr]                 */
+    case infoDouble :                   /* DOUBLE addr[-addr]                */
+    case infoTenBytes :                 /* TENBYTES addr[-addr]              */
+    // break before
+    case infoBreak :                    /* BREAK addr[-addr]                 */
+    case infoUnBreak:                   /* UNBREAK addr[-addr]               */
+      {
+      addr_t from, to, tgtaddr;
+      if (ParseInfoRange(value, from, to, pPre) >= 1)
         {
-        addr_t from, to, tgtaddr;
-        if (ParseInfoRange(value, from, to) >= 1)
+        for (addr_t scanned = from;
+             scanned >= from && scanned <= to;
+             scanned++)
           {
-          for (addr_t scanned = from;
-               scanned >= from && scanned <= to;
-               scanned++)
+          MemoryType ty = pDasm->GetMemType(scanned, infoBus);
+          int sz;
+          if (ty != Untyped)
             {
-            MemoryType ty = pDasm->GetMemType(scanned, infoBus);
-            int sz;
-            if (ty != Untyped)
+            switch (cmdType)
               {
-              switch (cmdType)
-                {
-                case infoCode :
-                  pDasm->SetMemType(scanned, Code, infoBus);
-                  break;
-                case infoData :
+              case infoCode :
+                pDasm->SetMemType(scanned, Code, infoBus);
+                break;
+              case infoData :
 #if 0
-                  // remove all code attributes
-                  if (ty == Code)
-                    {
-                    pDasm->SetCellSize(scanned, 1, infoBus);
-                    pDasm->SetDisplay(scanned, MemAttribute::Char, infoBus);
-                    }
+                // remove all code attributes
+                if (ty == Code)
+                  {
+                  pDasm->SetCellSize(scanned, 1, infoBus);
+                  pDasm->SetDisplay(scanned, MemAttribute::Char, infoBus);
+                  }
 #endif
-                  pDasm->SetMemType(scanned, Data, infoBus);
-                  break;
-                case infoConstant :
+                pDasm->SetMemType(scanned, Data, infoBus);
+                break;
+              case infoConstant :
 #if 0
-                  // remove all code attributes
-                  if (ty == Code)
-                    {
-                    pDasm->SetCellSize(scanned, 1, infoBus);
-                    pDasm->SetDisplay(scanned, MemAttribute::Char, infoBus);
-                    }
+                // remove all code attributes
+                if (ty == Code)
+                  {
+                  pDasm->SetCellSize(scanned, 1, infoBus);
+                  pDasm->SetDisplay(scanned, MemAttribute::Char, infoBus);
+                  }
 #endif
-                  pDasm->SetMemType(scanned, Const, infoBus);
-                  break;
-                case infoRMB :
+                pDasm->SetMemType(scanned, Const, infoBus);
+                break;
+              case infoRMB :
 #if 0
-                  // remove all code attributes
-                  if (ty == Code)
-                    {
-                    pDasm->SetCellSize(scanned, 1, infoBus);
-                    pDasm->SetDisplay(scanned, MemAttribute::Char, infoBus);
-                    }
-#endif
-                  pDasm->SetMemType(scanned, Bss, infoBus);
-                  break;
-                case infoUnused :
+                // remove all code attributes
+                if (ty == Code)
                   {
-                  pDasm->SetMemType(scanned, Untyped, infoBus);
-                  pDasm->SetCellUsed(scanned, false, infoBus);
-                  }
-                case infoByte :
                   pDasm->SetCellSize(scanned, 1, infoBus);
-                  break;
-                case infoWord :
-                  // for compatibility reasons to f9dasm, set type to Data
-                  if (ty != Const)
-                    pDasm->SetMemType(scanned, Data, infoBus);
-                  pDasm->SetCellSize(scanned, 2, infoBus);
-                  break;
-                case infoDWord :
-#if 0
-                  // for compatibility reasons to f9dasm, set type to Data
-                  if (ty != Const)
-                    pDasm->SetMemType(scanned, Data, infoBus);
-#endif
-                  pDasm->SetCellSize(scanned, 4, infoBus);
-                  break;
-                case infoBinary :
-                  pDasm->SetDisplay(scanned, MemAttribute::Binary, infoBus);
-                  break;
-                case infoChar :
                   pDasm->SetDisplay(scanned, MemAttribute::Char, infoBus);
-                  break;
-                case infoOct :
-                  pDasm->SetDisplay(scanned, MemAttribute::Octal, infoBus);
-                  break;
-                case infoDec :
-                  pDasm->SetDisplay(scanned, MemAttribute::Decimal, infoBus);
-                  break;
-                case infoHex :
-                  pDasm->SetDisplay(scanned, MemAttribute::Hex, infoBus);
-                  break;
-                case infoSigned :
-                  pDasm->SetCellType(scanned, MemAttribute::SignedInt, infoBus);
-                  break;
-                case infoUnsigned :
-                  pDasm->SetCellType(scanned, MemAttribute::UnsignedInt, infoBus);
-                  break;
-                case infoFloat :
-                  pDasm->SetCellSize(scanned, 4, infoBus);
-                  pDasm->SetCellType(scanned, MemAttribute::Float, infoBus);
-                  break;
-                case infoDouble :
-                  pDasm->SetCellSize(scanned, 8, infoBus);
-                  pDasm->SetCellType(scanned, MemAttribute::Float, infoBus);
-                  break;
-                case infoTenBytes :
-                  pDasm->SetCellSize(scanned, 10, infoBus);
-                  pDasm->SetCellType(scanned, MemAttribute::Float, infoBus);
-                  scanned += 9;
-                  break;
-                case infoBreak :
-                  pDasm->SetBreakBefore(scanned, true, infoBus);
-                  break;
-                case infoUnBreak:
-                  pDasm->SetBreakBefore(scanned, false, infoBus);
-                  break;
-                case infoCVector :
-                  // a code vector defines a table of code pointers
-                  if (ty != Data)
-                    {
-                    pDasm->SetMemType(scanned, Data, infoBus);
-                    pDasm->SetDisplay(scanned, MemAttribute::DefaultDisplay, infoBus);
-                    }
-                  sz = pDasm->GetCodePtrSize();
-                  pDasm->SetCellSize(scanned, sz, infoBus);
-                  tgtaddr = pDasm->GetTypedInt(scanned, infoBus);
-                  pDasm->AddLabel(tgtaddr, Code,
-                                  sformat("Z%0*Xvia%0*X",
-                                          sz*2, tgtaddr,
-                                          sz*2, scanned),
-                                  true, tgtBus);
-                  scanned += sz - 1;
-                  break;
-                case infoDVector :
-                  // a data vector defines a table of data pointers
-                  if (ty != Data)
-                    {
-                    pDasm->SetMemType(scanned, Data, infoBus);
-                    pDasm->SetDisplay(scanned, MemAttribute::DefaultDisplay, infoBus);
-                    }
-                  sz = pDasm->GetDataPtrSize();
-                  pDasm->SetCellSize(scanned, sz, infoBus);
-                  tgtaddr = pDasm->GetTypedInt(scanned, infoBus);
-                  pDasm->AddLabel(tgtaddr, Code,
-                                  sformat("M%0*Xvia%0*X",
-                                          sz*2, tgtaddr,
-                                          sz*2, scanned),
-                                  true, tgtBus);
-                  scanned += sz - 1;
-                  break;
+                  }
+#endif
+                pDasm->SetMemType(scanned, Bss, infoBus);
+                break;
+              case infoUnused :
+                {
+                pDasm->SetMemType(scanned, Untyped, infoBus);
+                pDasm->SetCellUsed(scanned, false, infoBus);
                 }
+              case infoByte :
+                pDasm->SetCellSize(scanned, 1, infoBus);
+                break;
+              case infoWord :
+                // for compatibility reasons to f9dasm, set type to Data
+                if (ty != Const)
+                  pDasm->SetMemType(scanned, Data, infoBus);
+                pDasm->SetCellSize(scanned, 2, infoBus);
+                break;
+              case infoDWord :
+#if 0
+                // for compatibility reasons to f9dasm, set type to Data
+                if (ty != Const)
+                  pDasm->SetMemType(scanned, Data, infoBus);
+#endif
+                pDasm->SetCellSize(scanned, 4, infoBus);
+                break;
+              case infoBinary :
+                pDasm->SetDisplay(scanned, MemAttribute::Binary, infoBus);
+                break;
+              case infoChar :
+                pDasm->SetDisplay(scanned, MemAttribute::Char, infoBus);
+                break;
+              case infoOct :
+                pDasm->SetDisplay(scanned, MemAttribute::Octal, infoBus);
+                break;
+              case infoDec :
+                pDasm->SetDisplay(scanned, MemAttribute::Decimal, infoBus);
+                break;
+              case infoHex :
+                pDasm->SetDisplay(scanned, MemAttribute::Hex, infoBus);
+                break;
+              case infoSigned :
+                pDasm->SetCellType(scanned, MemAttribute::SignedInt, infoBus);
+                break;
+              case infoUnsigned :
+                pDasm->SetCellType(scanned, MemAttribute::UnsignedInt, infoBus);
+                break;
+              case infoFloat :
+                pDasm->SetCellSize(scanned, 4, infoBus);
+                pDasm->SetCellType(scanned, MemAttribute::Float, infoBus);
+                break;
+              case infoDouble :
+                pDasm->SetCellSize(scanned, 8, infoBus);
+                pDasm->SetCellType(scanned, MemAttribute::Float, infoBus);
+                break;
+              case infoTenBytes :
+                pDasm->SetCellSize(scanned, 10, infoBus);
+                pDasm->SetCellType(scanned, MemAttribute::Float, infoBus);
+                scanned += 9;
+                break;
+              case infoBreak :
+                pDasm->SetBreakBefore(scanned, true, infoBus);
+                break;
+              case infoUnBreak:
+                pDasm->SetBreakBefore(scanned, false, infoBus);
+                break;
+              case infoCVector :
+                // a code vector defines a table of code pointers
+                if (ty != Data)
+                  {
+                  pDasm->SetMemType(scanned, Data, infoBus);
+                  pDasm->SetDisplay(scanned, MemAttribute::DefaultDisplay, infoBus);
+                  }
+                sz = pDasm->GetCodePtrSize();
+                pDasm->SetCellSize(scanned, sz, infoBus);
+                tgtaddr = pDasm->GetTypedInt(scanned, infoBus);
+                pDasm->AddLabel(tgtaddr, Code,
+                                sformat("Z%0*Xvia%0*X",
+                                        sz*2, tgtaddr,
+                                        sz*2, scanned),
+                                true, tgtBus);
+                scanned += sz - 1;
+                break;
+              case infoDVector :
+                // a data vector defines a table of data pointers
+                if (ty != Data)
+                  {
+                  pDasm->SetMemType(scanned, Data, infoBus);
+                  pDasm->SetDisplay(scanned, MemAttribute::DefaultDisplay, infoBus);
+                  }
+                sz = pDasm->GetDataPtrSize();
+                pDasm->SetCellSize(scanned, sz, infoBus);
+                tgtaddr = pDasm->GetTypedInt(scanned, infoBus);
+                pDasm->AddLabel(tgtaddr, Code,
+                                sformat("M%0*Xvia%0*X",
+                                        sz*2, tgtaddr,
+                                        sz*2, scanned),
+                                true, tgtBus);
+                scanned += sz - 1;
+                break;
               }
             }
           }
         }
-        break;
-      case infoRelative :               /* RELATIVE addr[-addr] rel          */
-        {
-        string range;
-        idx = value.find_first_of(" \t");
-        if (idx == value.npos) idx = value.size();
-        range = value.substr(0, idx);
-        value = trim(value.substr(idx));
-        addr_t from, to, rel;
-        if (ParseInfoRange(range, from, to) >= 1 &&
-            pDasm->String2Number(value, rel))
-          {
-          pDasm->AddRelative(from, to - from + 1, NULL, infoBus);
-          for (addr_t scanned = from;
-               scanned >= from && scanned <= to;
-               scanned++)
-           pDasm->SetRelative(scanned, rel, infoBus);
-          }
-        }
-        break;
-      case infoUnRelative :             /* UNRELATIVE addr[-addr]            */
-        {
-        addr_t from, to;
-        if (ParseInfoRange(value, from, to) >= 1)
-          {
-          for (addr_t scanned = from;
-               scanned >= from && scanned <= to;
-               scanned++)
-           pDasm->SetRelative(scanned, 0, infoBus);
-          }
-        }
-        break;
-      case infoLabel :                  /* LABEL addr[-addr] label           */
-      case infoDefLabel :               /* DEFLABEL addr[-addr] label        */
-      case infoUsedLabel :              /* USEDLABEL addr[-addr] [label]     */
+      }
+      break;
+    case infoRelative :                 /* RELATIVE addr[-addr] rel          */
+      {
+      string range;
+      idx = value.find_first_of(" \t");
+      if (idx == value.npos) idx = value.size();
+      range = value.substr(0, idx);
+      value = trim(value.substr(idx));
+      addr_t from, to, rel;
+      if (ParseInfoRange(range, from, to) >= 1 &&
+          pDasm->String2Number(value, rel))
         {
-        addr_t from, to;
-        string range;
-        idx = value.find_first_of(" \t");
-        if (idx == value.npos) idx = value.size();
-        range = value.substr(0, idx);
-        value = (idx < value.size()) ? triminfo(value.substr(idx), true, false) : "";
-        idx = value.find_first_of(" \t");
-        if (idx != value.npos)
-          value = trim(value.substr(0, idx));
-        bool bTextOk = (cmdType == infoUsedLabel) || value.size();
-        MemoryType memType =
-            (cmdType == infoDefLabel) ? Const :
-            Untyped;
-        bool bUsed = (/* cmdType == infoDefLabel || */ cmdType == infoUsedLabel);
-        if (ParseInfoRange(range, from, to) >= 1 && bTextOk)
-          {
-          bool bNoDelta = cmdType == infoUsedLabel && value.empty();
-          for (addr_t scanned = from;
-               scanned >= from && scanned <= to;
-               scanned++)
-            {
-            pDasm->AddLabel(
-                scanned, memType, 
-                (scanned == from || bNoDelta) ?
-                     value :
-                     sformat("%s+%d", value.c_str(), scanned - from),
-                bUsed,
-                infoBus);
-            }
-          }
+        pDasm->AddRelative(from, to - from + 1, NULL, infoBus);
+        for (addr_t scanned = from;
+             scanned >= from && scanned <= to;
+             scanned++)
+         pDasm->SetRelative(scanned, rel, infoBus);
         }
-        break;
-      case infoUnlabel :                /* UNLABEL addr[-addr]               */
+      }
+      break;
+    case infoUnRelative :               /* UNRELATIVE addr[-addr]            */
+      {
+      addr_t from, to;
+      if (ParseInfoRange(value, from, to, pPre) >= 1)
         {
-        addr_t from, to;
-        if (ParseInfoRange(value, from, to) >= 1)
-          {
-          for (int i = pDasm->GetLabelCount(infoBus) - 1; i >= 0; i--)
-            {
-            addr_t laddr = pDasm->LabelAt(i, infoBus)->GetAddress();
-            if (laddr < from) break;
-            if (laddr >= from && laddr <= to)
-              pDasm->RemoveLabelAt(i, infoBus);
-            }
-          }
+        pDasm->SetRelatives(from, to, 0, infoBus);
         }
-        break;
-      case infoPhase :                  /* PHASE addr[-addr] [+|-]phase      */
+      }
+      break;
+    case infoLabel :                    /* LABEL addr[-addr] label           */
+    case infoDefLabel :                 /* DEFLABEL addr[-addr] label        */
+    case infoUsedLabel :                /* USEDLABEL addr[-addr] [label]     */
+      {
+      addr_t from, to;
+      string range;
+      idx = value.find_first_of(" \t");
+      if (idx == value.npos) idx = value.size();
+      range = value.substr(0, idx);
+      value = (idx < value.size()) ? triminfo(value.substr(idx), true, false) : "";
+      idx = value.find_first_of(" \t");
+      if (idx != value.npos)
+        value = trim(value.substr(0, idx));
+      bool bTextOk = (cmdType == infoUsedLabel) || value.size();
+      MemoryType memType =
+          (cmdType == infoDefLabel) ? Const :
+          Untyped;
+      bool bUsed = (/* cmdType == infoDefLabel || */ cmdType == infoUsedLabel);
+      if (ParseInfoRange(range, from, to) >= 1 && bTextOk)
         {
-        string range;
-        idx = value.find_first_of(" \t");
-        if (idx == value.npos) idx = value.size();
-        range = value.substr(0, idx);
-        value = trim(value.substr(idx));
-        char sign = value.size() ? value[0] : 0;
-        bool bSigned = (sign == '+' || sign == '-');
-        addr_t from, to, phase;
-        if (ParseInfoRange(range, from, to) >= 1 &&
-            pDasm->String2Number(value, phase))
+        bool bNoDelta = cmdType == infoUsedLabel && value.empty();
+        for (addr_t scanned = from;
+             scanned >= from && scanned <= to;
+             scanned++)
           {
-          // This might cause garbage if overlapping or disjunct areas of
-          // different phase are specified. Well, so be it. Don't do it.
-          // The alternative would be to reallocate the phase area for each
-          // and every byte.
-          TMemory<addr_t, addr_t> *pFrom = pDasm->FindPhase(from, infoBus);
-          TMemory<addr_t, addr_t> *pTo = pDasm->FindPhase(to, infoBus);
-          if (!pFrom || !pTo)
-            {
-            // presumably, it's the same phase as others, so make sure
-            // to create a unique area
-            pDasm->AddPhase(from, to - from + 1, NO_ADDRESS, infoBus);
-            pFrom = pDasm->FindPhase(from, infoBus);
-            pFrom->SetType(phase);
-            }
-          for (addr_t scanned = from;
-               scanned >= from && scanned <= to;
-               scanned++)
-            {
-            TMemory<addr_t, addr_t> *pArea = pDasm->FindPhase(scanned, infoBus);
-            if (pArea)
-              {
-              if (pArea->GetType() == phase)
-                pDasm->SetPhase(scanned, NO_ADDRESS, infoBus);
-              else
-                pDasm->SetPhase(scanned,
-                                bSigned ? pArea->GetType() - phase : phase,
-                                infoBus);
-              }
-            }
+          pDasm->AddLabel(
+              scanned, memType, 
+              (scanned == from || bNoDelta) ?
+                   value :
+                   sformat("%s+%d", value.c_str(), scanned - from),
+              bUsed,
+              infoBus);
           }
         }
-        break;
-      case infoUnphase :                /* UNPHASE addr[-addr]               */
+      }
+      break;
+    case infoUnlabel :                  /* UNLABEL addr[-addr]               */
+      {
+      addr_t from, to;
+      if (ParseInfoRange(value, from, to, pPre) >= 1)
         {
-        addr_t from, to;
-        if (ParseInfoRange(value, from, to) >= 1)
-          {
-          for (addr_t scanned = from;
-               scanned >= from && scanned <= to;
-               scanned++)
-            pDasm->SetPhase(scanned, DEFAULT_ADDRESS, infoBus);
-          }
+        pDasm->RemoveLabels(from, to, infoBus);
         }
-        break;
-      case infoComment :                /* COMMENT [addr[-addr]] comment     */
-      case infoPrepComm :               /* PREPCOMM [addr[-addr]] comment    */
-      case infoInsert :                 /* INSERT [addr[-addr]] text         */
-      case infoPrepend :                /* PREPEND [addr[-addr]] line        */
-      case infoLComment :               /* LCOMMENT addr[-addr] [.]lcomment  */
-      case infoPrepLComm :              /* PREPLCOMM addr[-addr] [.]lcomment */
+      }
+      break;
+    case infoPhase :                    /* PHASE addr[-addr] [+|-]phase      */
+      {
+      string range;
+      idx = value.find_first_of(" \t");
+      if (idx == value.npos) idx = value.size();
+      range = value.substr(0, idx);
+      value = trim(value.substr(idx));
+      char sign = value.size() ? value[0] : 0;
+      bool bSigned = (sign == '+' || sign == '-');
+      addr_t from, to, phase;
+      if (ParseInfoRange(range, from, to) >= 1 &&
+          pDasm->String2Number(value, phase))
         {
-        // special: "AFTER" as 1st string (line comment ignores it)
-        bool bAfter = false;
-        bool bPrepend = cmdType == infoPrepComm ||
-                         cmdType == infoPrepend ||
-                         cmdType == infoPrepLComm;
-        bool bIsComm = cmdType == infoComment ||
-                       cmdType == infoPrepComm;
-        idx = value.find_first_of(" \t");
-        if (idx == value.npos) idx = value.size();
-        string after = lowercase(value.substr(0, idx));
-        if (after == "after")
+        // This might cause garbage if overlapping or disjunct areas of
+        // different phase are specified. Well, so be it. Don't do it.
+        // The alternative would be to reallocate the phase area for each
+        // and every byte.
+        TMemory<addr_t, addr_t> *pFrom = pDasm->FindPhase(from, infoBus);
+        TMemory<addr_t, addr_t> *pTo = pDasm->FindPhase(to, infoBus);
+        if (!pFrom || !pTo)
           {
-          bAfter = true;
-          value = (idx < value.size()) ? trim(value.substr(idx)) : "";
+          // presumably, it's the same phase as others, so make sure
+          // to create a unique area
+          pDasm->AddPhase(from, to - from + 1, NO_ADDRESS, infoBus);
+          pFrom = pDasm->FindPhase(from, infoBus);
+          pFrom->SetType(phase);
           }
-        addr_t from, to;
-        string range;
-        idx = value.find_first_of(" \t");
-        if (idx == value.npos) idx = value.size();
-        range = value.substr(0, idx);
-        // comments/inserts can have NO address, in which case they
-        // are output before anything else
-        if (ParseInfoRange(range, from, to) < 1)
-          idx = 0;
-        value = (idx >= value.size()) ? "" :
-          triminfo(value.substr(idx), true, true, true);
         for (addr_t scanned = from;
              scanned >= from && scanned <= to;
              scanned++)
           {
-                                        /* make sure comment breaks output   */
-          pDasm->SetBreakBefore(scanned, true, infoBus);
-          switch (cmdType)
+          TMemory<addr_t, addr_t> *pArea = pDasm->FindPhase(scanned, infoBus);
+          if (pArea)
             {
-            case infoComment :          /* COMMENT addr[-addr] comment       */
-            case infoPrepComm :         /* PREPCOMM [addr[-addr]] comment    */
-            case infoInsert :           /* INSERT addr[-addr] text           */
-            case infoPrepend :          /* PREPEND [addr[-addr]] line        */
-              AddComment(scanned, bAfter, value, bPrepend, bIsComm, infoBus);
-              break;
-            case infoLComment :         /* LCOMMENT addr[-addr] [.]lcomment  */
-            case infoPrepLComm :        /* PREPLCOMM addr[-addr] [.]lcomment */
-              if (scanned != NO_ADDRESS)
-                AddLComment(scanned, value, bPrepend, infoBus);
-              break;
+            if (pArea->GetType() == phase)
+              pDasm->SetPhase(scanned, NO_ADDRESS, infoBus);
+            else
+              pDasm->SetPhase(scanned,
+                              bSigned ? pArea->GetType() - phase : phase,
+                              infoBus);
             }
           }
         }
-        break;
-      case infoUncomment :              /* UNCOMMENT [AFTER] addr[-addr]     */
-      case infoUnLComment :             /* UNLCOMMENT addr[-addr]            */
+      }
+      break;
+    case infoUnphase :                  /* UNPHASE addr[-addr]               */
+      {
+      addr_t from, to;
+      if (ParseInfoRange(value, from, to, pPre) >= 1)
         {
-        // special: "AFTER" as 1st string (line comment ignores it)
-        bool bAfter = false;
-        idx = value.find_first_of(" \t");
-        if (idx == value.npos) idx = value.size();
-        string after = lowercase(value.substr(0, idx));
-        if (after == "after")
-          {
-          bAfter = true;
-          value = (idx < value.size()) ? trim(value.substr(idx)) : "";
-          }
-        addr_t from, to;
-        if (ParseInfoRange(value, from, to) >= 1)
+        pDasm->SetPhases(from, to, DEFAULT_ADDRESS, infoBus);
+        }
+      }
+      break;
+    case infoComment :                  /* COMMENT [addr[-addr]] comment     */
+    case infoPrepComm :                 /* PREPCOMM [addr[-addr]] comment    */
+    case infoInsert :                   /* INSERT [addr[-addr]] text         */
+    case infoPrepend :                  /* PREPEND [addr[-addr]] line        */
+    case infoLComment :                 /* LCOMMENT addr[-addr] [.]lcomment  */
+    case infoPrepLComm :                /* PREPLCOMM addr[-addr] [.]lcomment */
+      {
+      // special: "AFTER" as 1st string (line comment ignores it)
+      bool bAfter = false;
+      bool bPrepend = cmdType == infoPrepComm ||
+                       cmdType == infoPrepend ||
+                       cmdType == infoPrepLComm;
+      bool bIsComm = cmdType == infoComment ||
+                     cmdType == infoPrepComm;
+      idx = value.find_first_of(" \t");
+      if (idx == value.npos) idx = value.size();
+      string after = lowercase(value.substr(0, idx));
+      if (after == "after")
+        {
+        bAfter = true;
+        value = (idx < value.size()) ? trim(value.substr(idx)) : "";
+        }
+      addr_t from, to;
+      string range;
+      idx = value.find_first_of(" \t");
+      if (idx == value.npos) idx = value.size();
+      range = value.substr(0, idx);
+      // comments/inserts can have NO address, in which case they
+      // are output before anything else
+      if (ParseInfoRange(range, from, to) < 1)
+        idx = 0;
+      value = (idx >= value.size()) ? "" :
+        triminfo(value.substr(idx), true, true, true);
+      for (addr_t scanned = from;
+           scanned >= from && scanned <= to;
+           scanned++)
+        {
+                                        /* make sure comment breaks output   */
+        pDasm->SetBreakBefore(scanned, true, infoBus);
+        switch (cmdType)
           {
-          int i;
-          if (cmdType == infoUncomment)
-            {
-            for (i = GetCommentCount(bAfter, infoBus) - 1; i >= 0; i--)
-              {
-              AddrText *c = CommentAt(bAfter, i, infoBus);
-              addr_t caddr = c->GetAddress();
-              if (caddr < from) break;
-              if (caddr >= from && caddr <= to)
-                RemoveCommentAt(bAfter, i, infoBus);
-              }
-            }
-          else
-            {
-            for (i = GetLCommentCount(infoBus) - 1; i >= 0; i--)
-              {
-              AddrText *c = LCommentAt(i, infoBus);
-              addr_t caddr = c->GetAddress();
-              if (caddr < from) break;
-              if (caddr >= from && caddr <= to)
-                RemoveLCommentAt(i, infoBus);
-              }
-            }
+          case infoComment :            /* COMMENT addr[-addr] comment       */
+          case infoPrepComm :           /* PREPCOMM [addr[-addr]] comment    */
+          case infoInsert :             /* INSERT addr[-addr] text           */
+          case infoPrepend :            /* PREPEND [addr[-addr]] line        */
+            DeferComment(scanned, bAfter, value, bPrepend, bIsComm, infoBus);
+            break;
+          case infoLComment :           /* LCOMMENT addr[-addr] [.]lcomment  */
+          case infoPrepLComm :          /* PREPLCOMM addr[-addr] [.]lcomment */
+            if (scanned != NO_ADDRESS)
+              DeferLComment(scanned, value, bPrepend, infoBus);
+            break;
           }
         }
-        break;
-      case infoPatch :                  /* PATCH addr [byte]*                */
-      case infoPatchWord :              /* PATCHW addr [word]*               */
-      case infoPatchDWord :             /* PATCHDW addr [dword]*             */
-      case infoPatchFloat :             /* PATCHF addr [float]*              */
+      }
+      break;
+    case infoUncomment :                /* UNCOMMENT [AFTER] addr[-addr]     */
+    case infoUnLComment :               /* UNLCOMMENT addr[-addr]            */
+      {
+      // special: "AFTER" as 1st string (line comment ignores it)
+      bool bAfter = false;
+      idx = value.find_first_of(" \t");
+      if (idx == value.npos) idx = value.size();
+      string after = lowercase(value.substr(0, idx));
+      if (after == "after")
+        {
+        bAfter = true;
+        value = (idx < value.size()) ? trim(value.substr(idx)) : "";
+        }
+      addr_t from, to;
+      if (ParseInfoRange(value, from, to) >= 1)
+        {
+        MergeComments();                /* removal needs the sorted arrays   */
+        if (cmdType == infoUncomment)
+          RemoveComments(bAfter, from, to, infoBus);
+        else
+          RemoveLComments(from, to, infoBus);
+        }
+      }
+      break;
+    case infoPatch :                    /* PATCH addr [byte]*                */
+    case infoPatchWord :                /* PATCHW addr [word]*               */
+    case infoPatchDWord :               /* PATCHDW addr [dword]*             */
+    case infoPatchFloat :               /* PATCHF addr [float]*              */
+      {
+      addr_t from, to;
+      string range;
+      idx = value.find_first_of(" \t");
+      if (idx == value.npos) idx = value.size();
+      range = value.substr(0, idx);
+      value = (idx >= value.size()) ? "" :
+        triminfo(value.substr(idx), true, false);
+      if (ParseInfoRange(range, from, to) >= 1)
         {
-        addr_t from, to;
-        string range;
-        idx = value.find_first_of(" \t");
-        if (idx == value.npos) idx = value.size();
-        range = value.substr(0, idx);
-        value = (idx >= value.size()) ? "" :
-          triminfo(value.substr(idx), true, false);
-        if (ParseInfoRange(range, from, to) >= 1)
+        // "to" is not interesting here.
+        do
           {
-          // "to" is not interesting here.
-          do
+          if (from < pDasm->GetLowestCodeAddr() ||
+              from > pDasm->GetHighestCodeAddr())
+            break;
+          idx = value.find_first_of(" \t");
+          if (idx == value.npos) idx = value.size();
+          string item = value.substr(0, idx);
+          value = (idx >= value.size()) ? "" : trim(value.substr(idx));
+          to = 0;
+          switch (cmdType)
             {
-            if (from < pDasm->GetLowestCodeAddr() ||
-                from > pDasm->GetHighestCodeAddr())
+            case infoPatch :            /* PATCH addr [byte]*                */
+              if (sscanf(item.c_str(), "%x", &to) == 1)
+                {
+                if (pDasm->GetMemIndex(from, infoBus) == NO_ADDRESS)
+                  pDasm->AddMemory(from, 1, Code, NULL, infoBus);
+                pDasm->SetUByte(from++, (uint8_t)to, infoBus);
+                }
+              else
+                from = NO_ADDRESS;
               break;
-            idx = value.find_first_of(" \t");
-            if (idx == value.npos) idx = value.size();
-            string item = value.substr(0, idx);
-            value = (idx >= value.size()) ? "" : trim(value.substr(idx));
-            to = 0;
-            switch (cmdType)
+            case infoPatchWord :        /* PATCHW addr [word]*               */
+              if (sscanf(item.c_str(), "%x", &to) == 1)
+                {
+                if (pDasm->GetMemIndex(from, infoBus) == NO_ADDRESS)
+                  pDasm->AddMemory(from, 2, Data, NULL, infoBus);
+                pDasm->SetUWord(from, (uint16_t)to, infoBus);
+                from += 2;
+                }
+              else
+                from = NO_ADDRESS;
+              break;
+            case infoPatchDWord :       /* PATCHDW addr [dword]*             */
+              if (sscanf(item.c_str(), "%x", &to) == 1)
+                {
+                if (pDasm->GetMemIndex(from, infoBus) == NO_ADDRESS)
+                  pDasm->AddMemory(from, 4, Data, NULL, infoBus);
+                pDasm->SetUDWord(from, (uint32_t)to, infoBus);
+                from += 4;
+                }
+              else
+                from = NO_ADDRESS;
+              break;
+            case infoPatchFloat :       /* PATCHF addr [float]*              */
               {
-              case infoPatch :          /* PATCH addr [byte]*                */
-                if (sscanf(item.c_str(), "%x", &to) == 1)
-                  {
-                  if (pDasm->GetMemIndex(from, infoBus) == NO_ADDRESS)
-                    pDasm->AddMemory(from, 1, Code, NULL, infoBus);
-                  pDasm->SetUByte(from++, (uint8_t)to, infoBus);
-                  }
-                else
-                  from = NO_ADDRESS;
-                break;
-              case infoPatchWord :      /* PATCHW addr [word]*               */
-                if (sscanf(item.c_str(), "%x", &to) == 1)
-                  {
-                  if (pDasm->GetMemIndex(from, infoBus) == NO_ADDRESS)
-                    pDasm->AddMemory(from, 2, Data, NULL, infoBus);
-                  pDasm->SetUWord(from, (uint16_t)to, infoBus);
-                  from += 2;
-                  }
-                else
-                  from = NO_ADDRESS;
-                break;
-              case infoPatchDWord :     /* PATCHDW addr [dword]*             */
-                if (sscanf(item.c_str(), "%x", &to) == 1)
-                  {
-                  if (pDasm->GetMemIndex(from, infoBus) == NO_ADDRESS)
-                    pDasm->AddMemory(from, 4, Data, NULL, infoBus);
-                  pDasm->SetUDWord(from, (uint32_t)to, infoBus);
-                  from += 4;
-                  }
-                else
-                  from = NO_ADDRESS;
-                break;
-              case infoPatchFloat :     /* PATCHF addr [float]*              */
+              double d;
+              if (sscanf(item.c_str(), "%lf", &d) == 1)
                 {
-                double d;
-                if (sscanf(item.c_str(), "%lf", &d) == 1)
+                int sz;
+                if (pDasm->GetMemIndex(from, infoBus) == NO_ADDRESS)
                   {
-                  int sz;
-                  if (pDasm->GetMemIndex(from, infoBus) == NO_ADDRESS)
-                    {
-                    pDasm->AddMemory(from, 4, Data, NULL, infoBus);
-                    sz = 4;
-                    }
-                  else
-                    sz = pDasm->GetCellSize(from, infoBus);
-                  if (sz == 4)
-                    pDasm->SetFloat(from, (float)d, infoBus);
-                  else if (sz == 8)
-                    pDasm->SetDouble(from, d, infoBus);
-                  // Tenbytes ... no, sorry. Not yet. Maybe never.
-                  else
-                    from = NO_ADDRESS;
+                  pDasm->AddMemory(from, 4, Data, NULL, infoBus);
+                  sz = 4;
                   }
+                else
+                  sz = pDasm->GetCellSize(from, infoBus);
+                if (sz == 4)
+                  pDasm->SetFloat(from, (float)d, infoBus);
+                else if (sz == 8)
+                  pDasm->SetDouble(from, d, infoBus);
+                // Tenbytes ... no, sorry. Not yet. Maybe never.
                 else
                   from = NO_ADDRESS;
                 }
-                break;
+              else
+                from = NO_ADDRESS;
               }
+              break;
+            }
 
-            } while (value.size() && from != NO_ADDRESS);
-          }
+          } while (value.size() && from != NO_ADDRESS);
         }
-        break;
-      case infoEnd :
-        bEnd = true;
-        break;
       }
+      break;
+    case infoEnd :
+      bEnd = true;
+      break;
     }
-  line.clear();
-  bMod = false;
-  } while (fc != EOF && !bEnd);
+  }
 
-fclose(fp);
 return true;
 }
 
@@ -1847,7 +3694,7 @@ if (bSetDasm)                           /* 1st pass: find only dasm          */
     if (pDasm) delete pDasm;            /* use the last one                  */
     pDasm = CreateDisassembler(lvalue, &iDasm);
     if (!pDasm)
-      printf("Unknown disassembler \"%s\"\n", value.c_str());
+      Message(sformat("Unknown disassembler \"%s\"", value.c_str()));
     return 1;
     }
   else if (option != "info")            /* recurse through infofiles         */
@@ -1877,6 +3724,26 @@ else if (option == "out")
   outname = (value == "console") ? "" : value;
   return 1;
   }
+else if (option == "snapshot")
+  {
+  snapName = value;
+  return 1;
+  }
+else if (option == "infocache")
+  {
+  infoCacheDir = value;
+  return 1;
+  }
+else if (option == "outfmt" && (lvalue == "text" || lvalue == "json"))
+  {
+  outFormat = (lvalue == "json") ? ofJson : ofText;
+  return 1;
+  }
+else if (option == "inconce")
+  {
+  incOnce = !!bnvalue;
+  return 1;
+  }
 else if (option == "info")
   {
   bool bOK = LoadInfo(value, bProcInfo, bSetDasm);
@@ -2087,7 +3954,11 @@ else
   if (bAllOptions)
     ListDisassemblers(4);
   ListOptionLine("out", "Output File name", outname.size() ? outname : "console");
+  ListOptionLine("outfmt", "{text|json}\tOutput format", (outFormat == ofJson) ? "json" : "text");
   ListOptionLine("info", "Info File name");
+  ListOptionLine("snapshot", "Snapshot File name (reused while inputs are unchanged)");
+  ListOptionLine("infocache", "{dir}\tdirectory for compiled info files (off if empty)", infoCacheDir);
+  ListOptionLine("inconce", "{off|on}\tload each info file only once", incOnce ? "on" : "off");
   if (pDasm->GetBusCount() > 1)
     {
     string busses = pDasm->GetBusNames();
@@ -2127,6 +3998,8 @@ printf("\nOptions can be given in the following formats:\n"
 int Application::Help(bool bQuit, bool bAllOptions)
 {
 printf("Usage: %s [-option]* [filename]*\n", sDasmName.c_str());
+printf("       %s -server [-threads n] [-option]*   (one job command line per input line)\n", sDasmName.c_str());
+printf("       %s -batch manifest [-threads n] [-option]*   (one job per manifest line)\n", sDasmName.c_str());
 
 ListOptions(bAllOptions);               /* list options for selected dasm    */
 
@@ -42,9 +42,12 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <string>
 #include <vector>
+#include <map>
 #include <memory>
 using namespace std;
 
@@ -59,8 +62,8 @@ using namespace std;
 #define DASMFW_VERSION  "0.11"
 
 // set these to int64_t once 64bit processors become part of the framework
-typedef uint32_t caddr_t;               /* container for maximal code address*/
-typedef uint32_t daddr_t;               /* container for maximal data address*/
+typedef uint32_t codeaddr_t;            /* container for maximal code address*/
+typedef uint32_t dataaddr_t;            /* container for maximal data address*/
 typedef uint32_t addr_t;                /* bigger of the 2 above             */
 #define ADDR_T_SIZE 4                   /* sizeof(addr_t)                    */
 typedef int32_t saddr_t;                /* should be same size as addr_t     */
@@ -88,6 +91,12 @@ string uppercase(string s);
 string ltrim(string s);
 string trim(string s);
 string sformat(const string fmt_str, ...);
+// fast number formatting; these append to the passed string
+string &AppendHex(string &s, uint32_t value, int nDigits = 0, bool bUpper = true);
+string &AppendOct(string &s, uint32_t value, int nDigits = 0);
+string &AppendDec(string &s, uint32_t value, int nDigits = 0);
+string &AppendSigned(string &s, int32_t value);
+string &AppendBin(string &s, uint32_t value, int nBits);
 string triminfo
     (
     string s,
@@ -96,6 +105,73 @@ string triminfo
     bool bDotStart = false
     );
 
+/*****************************************************************************/
+/* KeywordTable : hashed keyword to command type translation                 */
+/*****************************************************************************/
+
+class KeywordTable
+  {
+  public:
+    struct Keyword
+      {
+      const char *name;                 /* keyword (uppercase)               */
+      int cmdType;                      /* associated command type           */
+      };
+
+    KeywordTable(const Keyword *keys, int nKeys);
+    // returns command type for an uppercase keyword, or notFound
+    int Find(const string &key, int notFound = -1) const;
+
+  protected:
+    static uint32_t Hash(const char *s, string::size_type len);
+    vector<const Keyword *> slots;      /* open addressing hash table        */
+    uint32_t mask;                      /* table size - 1                    */
+  };
+
+/*****************************************************************************/
+/* Threading helpers : minimal portable threads for concurrent jobs          */
+/*****************************************************************************/
+
+typedef void (*WorkerFunc)(void *pArg);
+
+int CountProcessors();
+// runs pFunc(pArg) on nThreads threads and waits until all are done;
+// if no thread can be created, pFunc runs on the calling thread
+void RunWorkers(int nThreads, WorkerFunc pFunc, void *pArg);
+// runs pFunc(pArg) on a thread of its own that nobody waits for
+bool StartWorker(WorkerFunc pFunc, void *pArg);
+// atomically adds n to *pValue, returning the previous value
+long FetchAndAdd(volatile long *pValue, long n = 1);
+
+class Mutex
+  {
+  public:
+    Mutex();
+    ~Mutex();
+    void Lock();
+    void Unlock();
+
+  protected:
+    void *pImpl;                        /* system-specific mutex             */
+  private:
+    Mutex(const Mutex &);               /* not copyable                      */
+    Mutex &operator=(const Mutex &);
+  };
+
+class Semaphore
+  {
+  public:
+    Semaphore(int nInitial = 0);
+    ~Semaphore();
+    void Wait();
+    void Post();
+
+  protected:
+    void *pImpl;                        /* system-specific semaphore         */
+  private:
+    Semaphore(const Semaphore &);       /* not copyable                      */
+    Semaphore &operator=(const Semaphore &);
+  };
 
 /*****************************************************************************/
 /* Automatic Disassembler Registration                                       */
@@ -103,6 +179,17 @@ string triminfo
 
 class Disassembler;
 bool RegisterDisassembler(string name, Disassembler * (*CreateDisassembler)());
+bool RegisterAllDisassemblers();
+
+// Backend registration functions; referenced from RegisterAllDisassemblers()
+// so that linking dasmfw as a library still pulls in all backends
+bool RegisterDasm6800();
+bool RegisterDasm6801();
+bool RegisterDasm6301();
+bool RegisterDasm6809();
+bool RegisterDasm6309();
+bool RegisterDasm68000();
+bool RegisterDasmAvr8();
 
 // This one relies on the global functions above
 #include "Memory.h"
@@ -142,10 +229,18 @@ class Comment : public AddrText
 class CommentArray : public TAddrTypeArray<Comment>
   {
   public:
-    CommentArray() : TAddrTypeArray<Comment>(true) { }
+    CommentArray() : TAddrTypeArray<Comment>(true), seqPos(0) { }
+    ~CommentArray()
+      {
+      // anything still deferred here was never merged; just free it
+      for (vector<Deferred>::size_type i = 0; i < deferred.size(); i++)
+        delete deferred[i].pEl;
+      }
+    // comments are looked up in ascending address order while the
+    // listing is generated, so search from the last position
     Comment *GetFirst(addr_t addr, CommentArray::iterator &it)
       {
-      it = find(addr, Data);
+      it = findseq(addr, seqPos);
       return it != end() ? (Comment *)(*it) : NULL;
       }
     Comment *GetNext(addr_t addr, CommentArray::iterator &it)
@@ -153,8 +248,142 @@ class CommentArray : public TAddrTypeArray<Comment>
       it++;
       return (it != end() && (*it)->GetAddress() == addr) ? (Comment *)(*it) : NULL;
       }
+    // bulk loading: collect comments in any order, then merge them into
+    // the array in one pass, in the order single inserts would produce
+    void Defer(Comment *pNewEl, bool bAfter = true)
+      {
+      Deferred d = { pNewEl, bAfter, deferred.size() };
+      deferred.push_back(d);
+      }
+    void Merge();
+
+  protected:
+    struct Deferred
+      {
+      Comment *pEl;                     /* comment to be inserted            */
+      bool bAfter;                      /* insert after existing ones        */
+      size_type seq;                    /* sequence of Defer() calls         */
+      };
+    static bool DeferredLess(const Deferred &a, const Deferred &b);
+
+  protected:
+    size_type seqPos;                   /* cursor for GetFirst()             */
+    vector<Deferred> deferred;          /* comments waiting for Merge()      */
+  };
+
+
+/*****************************************************************************/
+/* OutputSink : buffered destination for the disassembly listing             */
+/*****************************************************************************/
+
+class OutputSink
+  {
+  public:
+    OutputSink() : fp(stdout), fpCopy(NULL) { buf.reserve(FlushSize + 256); }
+    ~OutputSink() { Close(); }
+
+    bool Open(string fileName = "");    /* "" for console                    */
+    bool Close();
+    bool Flush();
+    bool Write(const char *data, size_t len);
+
+    // write everything that's flushed to a second file as well, with a
+    // running hash over it; EndCopy() returns the file for completion
+    void CopyTo(FILE *fp, uint32_t hash)
+      { fpCopy = fp; copyHash = hash; copySize = 0; bCopyOK = true; }
+    FILE *EndCopy(uint32_t &size, uint32_t &hash, bool &bOK)
+      {
+      FILE *fpRet = fpCopy;
+      size = copySize; hash = copyHash; bOK = bCopyOK;
+      fpCopy = NULL;
+      return fpRet;
+      }
+
+    bool IsConsole() { return fp == stdout; }
+
+    void Put(const string &s) { buf += s; }
+    void EndLine()
+      {
+      buf += '\n';
+      if (buf.size() >= FlushSize)
+        Flush();
+      }
+
+  protected:
+    enum { FlushSize = 65536 };
+    FILE *fp;                           /* output file, stdout or NULL       */
+    string buf;                         /* pending output                    */
+    FILE *fpCopy;                       /* copy of the output, or NULL       */
+    uint32_t copyHash;                  /* running hash over the copy        */
+    uint32_t copySize;                  /* # bytes in the copy               */
+    bool bCopyOK;                       /* flag whether copy is complete     */
+
+    void CopyOut(const char *data, size_t len);
   };
 
+/*****************************************************************************/
+/* ListingLine : a line of the disassembly listing before text rendering     */
+/*****************************************************************************/
+
+struct ListingLine
+  {
+  enum Kind
+    {
+    lkText,                             /* header or other free text         */
+    lkComment,                          /* comment line                      */
+    lkInsert,                           /* inserted text line                */
+    lkChange,                           /* disassembler-specific change      */
+    lkLabel,                            /* label without code / data         */
+    lkDefLabel,                         /* definition label                  */
+    lkCode,                             /* code line                         */
+    lkData,                             /* data line                         */
+    lkLineComment                       /* additional line comment           */
+    };
+
+  ListingLine(int kind = lkText, addr_t addr = NO_ADDRESS, addr_t size = 0,
+              int bus = BusCode, string sLabel = "", string smnemo = "",
+              string sparm = "", string scomment = "", int labelLen = -1)
+    : kind(kind), addr(addr), size(size), bus(bus),
+      sLabel(sLabel), smnemo(smnemo), sparm(sparm), scomment(scomment),
+      labelLen(labelLen)
+    { }
+
+  int kind;                             /* line kind                         */
+  addr_t addr;                          /* address or NO_ADDRESS             */
+  addr_t size;                          /* # bytes covered by the line       */
+  int bus;                              /* bus the address belongs to        */
+  string sLabel;                        /* label column                      */
+  string smnemo;                        /* mnemonic column                   */
+  string sparm;                         /* parameter column                  */
+  string scomment;                      /* comment column                    */
+  int labelLen;                         /* label len override, -1 = default */
+  string slcomment;                     /* raw line comment text             */
+  };
+
+/*****************************************************************************/
+/* ListingSink : receiver for the listing when dasmfw is embedded            */
+/*****************************************************************************/
+
+class ListingSink
+  {
+  public:
+    virtual ~ListingSink() { }
+    // called for each listing line with its rendered text (no trailing
+    // newline); returning false ends the output
+    virtual bool Line(const ListingLine &line, const string &text) = 0;
+  };
+
+/*****************************************************************************/
+/* MessageSink : receiver for status messages when dasmfw is embedded        */
+/*****************************************************************************/
+
+class MessageSink
+  {
+  public:
+    virtual ~MessageSink() { }
+    // called for each status message ("Loaded: ...", ...), without newline
+    virtual void Message(const string &text) = 0;
+  };
 
 /*****************************************************************************/
 /* Application : main application class                                      */
@@ -168,13 +397,48 @@ public:
 
   int Run();
 
+  struct InfoLine                       /* compiled info file line           */
+    {
+    InfoLine() : nRange(-1), from(NO_ADDRESS), to(NO_ADDRESS) { }
+    string key;                         /* uppercase keyword                 */
+    string value;                       /* trimmed rest of the line          */
+    int nRange;                         /* pre-resolved range, -1 if none    */
+    addr_t from, to;                    /* (raw String2Range() of the value) */
+    };
+  typedef map<string, vector<InfoLine> > InfoCache;
+  static void SplitInfo(const string &text, vector<InfoLine> &lines);
+  // file name at the start of an INCLUDE / FILE value; *pNext receives
+  // the position behind it
+  static string InfoFileName(const string &value, string::size_type *pNext = NULL);
+
   bool LoadInfo(string fileName, bool bProcInfo = true, bool bSetDasm = false)
     {
     vector<string> loadStack;
-    return LoadInfo(fileName, loadStack, bProcInfo, bSetDasm);
+    bool bOK = LoadInfo(fileName, loadStack, bProcInfo, bSetDasm);
+    if (bProcInfo)                      /* put collected comments in place   */
+      MergeComments();
+    return bOK;
     }
 
+  // embedding interface; to be used before Run()
+  void AddInfoText(string name, const string &text)
+    { infoTexts[name] = text; infoCache.erase(name); }
+  void AddLoadBuffer(const uint8_t *data, addr_t len, addr_t addr, int bus = BusCode)
+    {
+    loadBuffers.push_back(LoadBuffer());
+    loadBuffers.back().data.assign(data, data + len);
+    loadBuffers.back().addr = addr;
+    loadBuffers.back().bus = bus;
+    }
+  // with a sink, the listing is not written to the output file, and
+  // -snapshot is ignored, since a snapshot only holds the rendered text
+  void SetListingSink(ListingSink *pNewSink = NULL) { pSink = pNewSink; }
+  void SetMessageSink(MessageSink *pNewSink = NULL) { pMsgSink = pNewSink; }
+  // compiled info files shared between jobs; must not change during Run()
+  void SetSharedInfo(const InfoCache *pShared = NULL) { pSharedInfo = pShared; }
+
 protected:
+  void Message(const string &text);
   bool LoadFiles();
   bool LoadInfoFiles();
   bool Parse(int nPass, int bus = BusCode);
@@ -183,9 +447,43 @@ protected:
   bool DisassembleLabels(string sComDel, string sComHdr, int bus = BusCode);
   bool DisassembleDefLabels(string sComDel, string sComHdr, int bus = BusCode);
   addr_t DisassembleLine(addr_t addr, string sComDel, string sComHdr, string labelDelim, int bus = BusCode);
-  bool PrintLine(string sLabel = "", string smnemo = "", string sparm = "", string scomment = "", int labelLen = -1);
+  bool PrintLine(string sLabel = "", string smnemo = "", string sparm = "", string scomment = "", int labelLen = -1)
+    { return AddLine(ListingLine(ListingLine::lkText, NO_ADDRESS, 0, BusCode, sLabel, smnemo, sparm, scomment, labelLen)); }
+  bool AddLine(const ListingLine &line)
+    {
+    listing.push_back(line);            /* render in blocks of bounded size  */
+    return (listing.size() < ListingBlockSize) || RenderListing();
+    }
+  bool AddLineComment(addr_t addr, string sComBlk, string sComment, int bus = BusCode)
+    {
+    ListingLine line(ListingLine::lkLineComment, addr, 0, bus, "", "", "", sComBlk + sComment);
+    line.slcomment = sComment;
+    return AddLine(line);
+    }
+  bool RenderListing();
+  bool RenderLine(const ListingLine &line, string &s);
+  bool RenderJsonLine(const ListingLine &line, string &s);
+  string SnapshotHeader();
+  uint32_t InfoParseHash(string fileName, uint32_t h);
+  bool RestoreSnapshot();
+  bool SaveSnapshot();
+  void SaveInfoLabels();
+  void SaveParse();
+  bool ApplyParse(bool bApply);
+  bool RestoreParse();
   bool LoadInfo(string fileName, vector<string> &loadStack, bool bProcInfo = true, bool bSetDasm = false);
-  int ParseInfoRange(string value, addr_t &from, addr_t &to);
+  const vector<InfoLine> *CompileInfo(string fileName);
+  string InfoRangeKey();
+  string InfoCacheName(const string &fileName);
+  struct InfoFileState
+    {
+    uint32_t mtime;                     /* modification time                 */
+    uint32_t size;                      /* file size                         */
+    uint32_t hash;                      /* FNV-1a over the file contents     */
+    };
+  bool ReadInfoCache(string fileName, const InfoFileState &state);
+  bool WriteInfoCache();
+  int ParseInfoRange(string value, addr_t &from, addr_t &to, const InfoLine *pPre = NULL);
   int ParseOption
     (
     string option,                      /* option name                       */
@@ -212,6 +510,11 @@ protected:
     comments[bAfter][bus].insert(new Comment(addr, sComment, bIsComment), !bPrepend);
     return true;
     }
+  bool DeferComment(addr_t addr, bool bAfter = false, string sComment = "", bool bPrepend = false, bool bIsComment = true, int bus = BusCode)
+    {
+    comments[bAfter][bus].Defer(new Comment(addr, sComment, bIsComment), !bPrepend);
+    return true;
+    }
   Comment *GetFirstComment(addr_t addr, CommentArray::iterator &it, bool bAfter = false, int bus = BusCode)
     { return comments[bAfter][bus].GetFirst(addr, it); }
   Comment *GetNextComment(addr_t addr, CommentArray::iterator &it, bool bAfter = false, int bus = BusCode)
@@ -220,6 +523,7 @@ protected:
   int GetCommentCount(bool bAfter, int bus = BusCode) { return comments[bAfter][bus].size(); }
   Comment *CommentAt(bool bAfter, int index, int bus = BusCode) { return comments[bAfter][bus].at(index); }
   void RemoveCommentAt(bool bAfter, int index, int bus = BusCode) { comments[bAfter][bus].erase(comments[bAfter][bus].begin() + index); }
+  void RemoveComments(bool bAfter, addr_t from, addr_t to, int bus = BusCode) { comments[bAfter][bus].eraserange(from, to); }
 
   // Line Comment handling
   bool AddLComment(addr_t addr, string sComment = "", bool bPrepend = false, int bus = BusCode)
@@ -227,6 +531,12 @@ protected:
     lcomments[bus].insert(new Comment(addr, sComment), !bPrepend);
     return true;
     }
+  bool DeferLComment(addr_t addr, string sComment = "", bool bPrepend = false, int bus = BusCode)
+    {
+    lcomments[bus].Defer(new Comment(addr, sComment), !bPrepend);
+    return true;
+    }
+  void MergeComments();
   Comment *GetFirstLComment(addr_t addr, CommentArray::iterator &it, int bus = BusCode)
     { return lcomments[bus].GetFirst(addr, it); }
   Comment *GetNextLComment(addr_t addr, CommentArray::iterator &it, int bus = BusCode)
@@ -234,6 +544,7 @@ protected:
   int GetLCommentCount(int bus = BusCode) { return lcomments[bus].size(); }
   Comment *LCommentAt(int index, int bus = BusCode) { return lcomments[bus].at(index); }
   void RemoveLCommentAt(int index, int bus = BusCode) { lcomments[bus].erase(lcomments[bus].begin() + index); }
+  void RemoveLComments(addr_t from, addr_t to, int bus = BusCode) { lcomments[bus].eraserange(from, to); }
 
 
 protected:
@@ -244,9 +555,23 @@ protected:
   int iDasm;                            /* index of selected disassembler    */
   vector<string> saFNames;              /* array of files to load            */
   vector<string> saINames;              /* array of info files to load       */
-  vector<string> saPINames;             /* array of processed info files     */
+  map<string, int> infoLoaded;          /* info files loaded per phase       */
   string outname;                       /* output file name                  */
-  FILE *out;                            /* output file                       */
+  OutputSink out;                       /* output destination                */
+  enum OutputFormat
+    {
+    ofText,                             /* formatted assembler listing       */
+    ofJson                              /* one JSON record per listing line  */
+    };
+  OutputFormat outFormat;               /* output format                     */
+  string snapName;                      /* snapshot file name                */
+  string snapHeader;                    /* snapshot input description        */
+  uint32_t parseKey;                    /* hash over all inputs of Parse()   */
+  string parseState;                    /* state after Parse() for reuse     */
+  string infoLabelState;                /* labels before Parse(), for reuse  */
+  // illegal instructions found by Parse(), as (address, bus)
+  vector<pair<addr_t, int> > illegalInsts;
+  string infoCacheDir;                  /* directory for compiled info files */
 
   bool abortHelp;                       /* abort after help has been given   */
   int infoBus;                          /* current info file bus selection   */
@@ -256,12 +581,15 @@ protected:
   bool showUnused;                      /* flag for showing unused labels    */
   bool showComments;                    /* flag for showing comments         */
   bool f9dasmComp;                      /* flag for f9dasm compatibility     */
+  bool incOnce;                         /* flag for include-once semantics   */
   int labelLen;                         /* minimum label display length      */
   int lLabelLen;                        /* minimum label len for EQUs        */
   int mnemoLen;                         /* minimum mnemonics display length  */
   int cparmLen;                         /* min parm len with lcomment        */
   int uparmLen;                         /* max parm len without lcomment     */
   int dbCount;                          /* min bytes for hex/asc dump        */
+  bool bULHOut;                         /* "Used Labels" header output       */
+  bool bUDHOut;                         /* "Used Definitions" header output  */
 
   // remap arrays
   vector<TMemoryArray<addr_t>> remaps;
@@ -269,6 +597,28 @@ protected:
   vector<CommentArray> comments[2];
   // line comment arrays
   vector<CommentArray> lcomments;
+  // compiled info files, read once per run
+  InfoCache infoCache;
+  const InfoCache *pSharedInfo;
+  // persistent info cache; resolver the ranges were pre-resolved with,
+  // source file state of the files to write to the cache
+  map<string, string> infoRangeKeys;
+  map<string, InfoFileState> infoToCache;
+  // in-memory info texts and data areas, sinks for embedding
+  map<string, string> infoTexts;
+  struct LoadBuffer
+    {
+    vector<uint8_t> data;               /* area contents                     */
+    addr_t addr;                        /* start address                     */
+    int bus;                            /* target bus                        */
+    };
+  vector<LoadBuffer> loadBuffers;
+  ListingSink *pSink;
+  MessageSink *pMsgSink;
+  bool bSinkDone;                       /* sink doesn't want any more lines  */
+  // listing lines waiting to be rendered
+  enum { ListingBlockSize = 1024 };
+  vector<ListingLine> listing;
 };
 
 #endif // __dasmfw_h_defined__